@@ -21,6 +21,9 @@ public:
     void lock() { ::EnterCriticalSection(&cs_); }
     void unlock() { ::LeaveCriticalSection(&cs_); }
 
+    // This should be only used with soci_condition_t.
+    CRITICAL_SECTION * native_handle() { return &cs_; }
+
     soci_mutex_t(soci_mutex_t const &) = delete;
     soci_mutex_t& operator=(soci_mutex_t const &) = delete;
 
@@ -28,9 +31,35 @@ private:
     CRITICAL_SECTION cs_;
 };
 
+class soci_condition_t
+{
+public:
+    soci_condition_t() { ::InitializeConditionVariable(&cv_); }
+
+    soci_condition_t(soci_condition_t const &) = delete;
+    soci_condition_t& operator=(soci_condition_t const &) = delete;
+
+    // Wait for the condition to be signaled or the timeout, in milliseconds,
+    // to expire, with the negative timeout meaning waiting forever. The mutex
+    // must be locked by the caller. Returns false if the timeout expired or,
+    // in principle, if waiting failed.
+    bool wait(soci_mutex_t & m, int timeout)
+    {
+        return ::SleepConditionVariableCS(&cv_, m.native_handle(),
+                    timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE) != 0;
+    }
+
+    void notify_one() { ::WakeConditionVariable(&cv_); }
+    void notify_all() { ::WakeAllConditionVariable(&cv_); }
+
+private:
+    CONDITION_VARIABLE cv_;
+};
+
 #else // Assume POSIX
 
 #include <pthread.h>
+#include <sys/time.h>
 
 class soci_mutex_t
 {
@@ -51,6 +80,50 @@ private:
     pthread_mutex_t m_;
 };
 
+class soci_condition_t
+{
+public:
+    soci_condition_t() { pthread_cond_init(&cv_, nullptr); }
+    soci_condition_t(soci_condition_t const &) = delete;
+    soci_condition_t& operator=(soci_condition_t const &) = delete;
+
+    ~soci_condition_t() { pthread_cond_destroy(&cv_); }
+
+    // Wait for the condition to be signaled or the timeout, in milliseconds,
+    // to expire, with the negative timeout meaning waiting forever. The mutex
+    // must be locked by the caller. Returns false if the timeout expired or,
+    // in principle, if waiting failed.
+    bool wait(soci_mutex_t & m, int timeout)
+    {
+        if (timeout < 0)
+        {
+            return pthread_cond_wait(&cv_, m.native_handle()) == 0;
+        }
+
+        // pthread_cond_timedwait() takes absolute time.
+        struct timeval tmv;
+        gettimeofday(&tmv, nullptr);
+
+        struct timespec tm;
+        tm.tv_sec = tmv.tv_sec + timeout / 1000;
+        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+
+        if (tm.tv_nsec >= 1000 * 1000 * 1000)
+        {
+            ++tm.tv_sec;
+            tm.tv_nsec -= 1000 * 1000 * 1000;
+        }
+
+        return pthread_cond_timedwait(&cv_, m.native_handle(), &tm) == 0;
+    }
+
+    void notify_one() { pthread_cond_signal(&cv_); }
+    void notify_all() { pthread_cond_broadcast(&cv_); }
+
+private:
+    pthread_cond_t cv_;
+};
+
 #endif // _WIN32/POSIX
 
 class soci_scoped_lock
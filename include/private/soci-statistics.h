@@ -0,0 +1,75 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_STATISTICS_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_STATISTICS_H_INCLUDED
+
+#include "soci/logger.h"
+#include "soci/session-statistics.h"
+
+#include "soci-mutex.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Collects the statistics returned by session::get_statistics().
+//
+// All functions of this class may be called concurrently, as the statistics
+// of the sessions of a connection pool can be retrieved while they're used.
+class statistics_collector
+{
+public:
+    // Maximal number of distinct queries for which the statistics are kept,
+    // the other ones are only taken into account in the totals.
+    static constexpr std::size_t max_queries = 1000;
+
+    statistics_collector() = default;
+    statistics_collector(statistics_collector const &) = delete;
+    statistics_collector& operator=(statistics_collector const &) = delete;
+
+    void add_prepare();
+    void add_cache_hit();
+    void add_exception();
+
+    // Update the statistics after executing the query or fetching data from
+    // it, with the given part of the total time spent in the backend. The
+    // statistics of the queries with the same fingerprint are combined.
+    void add_execute(query_end_info const & info,
+                     std::chrono::steady_clock::duration backendTime);
+    void add_fetch(query_end_info const & info,
+                   std::chrono::steady_clock::duration backendTime);
+
+    session_statistics get(std::size_t topQueries) const;
+    void reset();
+
+private:
+    // Must be called with the mutex locked.
+    void do_add(query_end_info const & info,
+                std::chrono::steady_clock::duration backendTime,
+                bool isExecute);
+
+    mutable soci_mutex_t mutex_;
+
+    // The totals, without any top queries.
+    session_statistics totals_;
+
+    // Indexed by the query fingerprint hash.
+    std::unordered_map<std::uint64_t, query_statistics> queries_;
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_STATISTICS_H_INCLUDED
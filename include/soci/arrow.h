@@ -0,0 +1,90 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_ARROW_H_INCLUDED
+#define SOCI_ARROW_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/column-batch.h"
+// std
+#include <cstdint>
+
+// The structures below are defined by the Apache Arrow C Data Interface
+// specification (https://arrow.apache.org/docs/format/CDataInterface.html)
+// and can be used without depending on the Arrow library. The guard macro is
+// the one recommended by the specification, so that these definitions can
+// coexist with the ones from Arrow headers.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C"
+{
+
+struct ArrowSchema
+{
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray
+{
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace soci
+{
+
+// Export the rows currently contained in the batch, i.e. fetched by the last
+// call to statement::fetch(), as an Arrow struct array with one child array
+// for each column.
+//
+// Both the schema and the array are filled by this function and must be
+// released by the consumer by calling their release callbacks. The data is
+// copied into the buffers owned by the array, so the batch can be reused
+// for fetching the next rows immediately.
+//
+// Integer and floating point columns are exported using the corresponding
+// Arrow types, strings as UTF-8 strings and dates as timestamps with second
+// precision and without time zone.
+SOCI_DECL void export_to_arrow(column_batch const& batch,
+                               ArrowSchema* schema,
+                               ArrowArray* array);
+
+} // namespace soci
+
+#endif // SOCI_ARROW_H_INCLUDED
@@ -0,0 +1,72 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
+#define SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
+
+#include "soci/into-type.h"
+#include "soci/exchange-traits.h"
+#include "soci/column-batch.h"
+#include "soci/statement.h"
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Support selecting into a column_batch for dynamic queries
+
+template <>
+class into_type<column_batch>
+    : public into_type_base // bypass the standard_into_type
+{
+public:
+    into_type(column_batch & b) : b_(b), size_(b.capacity()) {}
+    into_type(column_batch & b, indicator &) : b_(b), size_(b.capacity()) {}
+
+private:
+    void define(statement_impl & st, int & /* position */) override
+    {
+        st.set_column_batch(&b_);
+
+        // actual columns description is performed as part of the statement
+        // execute and the vectors for them are bound at that time
+    }
+
+    void pre_exec(int /* num */) override {}
+    void pre_fetch() override {}
+    void post_fetch(bool /* gotData */, bool /* calledFromFetch */) override {}
+    void clean_up() override {}
+
+    // The batch behaves as a vector of rows, so that the statement fetches
+    // the right number of rows into it.
+    std::size_t size() const override { return size_; }
+    void resize(std::size_t sz) override
+    {
+        size_ = sz;
+        b_.set_number_of_rows(sz);
+    }
+
+    column_batch & b_;
+    std::size_t size_;
+
+    SOCI_NOT_COPYABLE(into_type)
+};
+
+template <>
+struct exchange_traits<column_batch>
+{
+    typedef basic_type_tag type_family;
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
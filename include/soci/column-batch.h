@@ -0,0 +1,184 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_COLUMN_BATCH_H_INCLUDED
+#define SOCI_COLUMN_BATCH_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/row.h"
+// std
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Storage of the values of a single column of column_batch.
+class column_batch_column_base
+{
+public:
+    explicit column_batch_column_base(std::size_t capacity)
+        : indicators_(capacity, i_ok)
+    {}
+
+    virtual ~column_batch_column_base() {}
+
+    virtual holder get_holder(std::size_t row) = 0;
+    virtual void resize(std::size_t rows) = 0;
+
+    std::vector<indicator> indicators_;
+};
+
+template <typename T>
+class column_batch_column : public column_batch_column_base
+{
+public:
+    explicit column_batch_column(std::size_t capacity)
+        : column_batch_column_base(capacity), values_(capacity)
+    {}
+
+    holder get_holder(std::size_t row) override
+    {
+        return holder::make_holder(&values_.at(row));
+    }
+
+    // Never reallocates the storage as long as rows doesn't exceed the
+    // capacity, so the vectors remain bound to the statement.
+    void resize(std::size_t rows) override
+    {
+        values_.resize(rows);
+        indicators_.resize(rows);
+    }
+
+    std::vector<T> values_;
+};
+
+} // namespace details
+
+// Columnar storage for a batch of rows of a dynamically described result:
+// when used with a statement, its columns are described during execution and
+// a vector of values and of indicators is allocated for each of them, so that
+// each fetch() retrieves up to capacity() rows at once.
+class SOCI_DECL column_batch
+{
+public:
+    explicit column_batch(std::size_t capacity);
+    ~column_batch();
+
+    void uppercase_column_names(bool forceToUpper);
+
+    // Maximal number of rows fetched at once.
+    std::size_t capacity() const { return capacity_; }
+
+    // Number of rows retrieved by the last fetch.
+    std::size_t get_number_of_rows() const { return rows_; }
+
+    std::size_t get_number_of_columns() const { return columns_.size(); }
+
+    column_properties const& get_properties(std::size_t pos) const;
+    column_properties const& get_properties(std::string const& name) const;
+
+    // Return all values of the given column, only the first
+    // get_number_of_rows() of which are valid. T must be the type used for
+    // exchanging the column data, i.e. std::string, std::wstring, double,
+    // std::tm or one of the fixed size integer types, std::bad_cast is
+    // thrown if it is not the right one.
+    template <typename T>
+    std::vector<T> const& get_column(std::size_t pos) const
+    {
+        details::column_batch_column<T> const* const
+            column = dynamic_cast<details::column_batch_column<T> const*>(
+                        columns_.at(pos).get());
+        if (!column)
+        {
+            throw std::bad_cast();
+        }
+
+        return column->values_;
+    }
+
+    // Check if the column values have the given type.
+    template <typename T>
+    bool is_of_type(std::size_t pos) const
+    {
+        return dynamic_cast<details::column_batch_column<T> const*>(
+                    columns_.at(pos).get()) != nullptr;
+    }
+
+    template <typename T>
+    std::vector<T> const& get_column(std::string const& name) const
+    {
+        return get_column<T>(find_column(name));
+    }
+
+    std::vector<indicator> const& get_indicators(std::size_t pos) const;
+    std::vector<indicator> const& get_indicators(std::string const& name) const;
+
+    // Return the position of the column with the given name or throw if
+    // there is no such column.
+    std::size_t find_column(std::string const& name) const;
+
+    // Return the holder for the value in the given row and column.
+    details::holder get_holder(std::size_t row, std::size_t pos) const
+    {
+        return columns_.at(pos)->get_holder(row);
+    }
+
+    // Return the value in the given row and column, which must not be null.
+    template <typename T>
+    T const& get(std::size_t row, std::size_t pos) const
+    {
+        if (get_indicators(pos).at(row) == i_null)
+        {
+            throw soci_error("Null value not allowed for this type");
+        }
+
+        return get_column<T>(pos).at(row);
+    }
+
+    // The functions below are used by the statement only.
+
+    void clean_up();
+    void add_properties(column_properties const& cp);
+
+    template <typename T>
+    details::column_batch_column<T>& add_column()
+    {
+        details::column_batch_column<T>* const
+            column = new details::column_batch_column<T>(capacity_);
+        columns_.emplace_back(column);
+        return *column;
+    }
+
+    void set_number_of_rows(std::size_t rows) { rows_ = rows; }
+
+    // Change the size of the vectors of all columns, which can't exceed the
+    // capacity.
+    void resize_columns(std::size_t rows);
+
+private:
+    SOCI_NOT_COPYABLE(column_batch)
+
+    std::size_t const capacity_;
+    std::size_t rows_;
+
+    std::vector<column_properties> properties_;
+    std::vector<std::unique_ptr<details::column_batch_column_base>> columns_;
+    std::map<std::string, std::size_t> index_;
+
+    bool uppercaseColumnNames_;
+};
+
+} // namespace soci
+
+#endif // SOCI_COLUMN_BATCH_H_INCLUDED
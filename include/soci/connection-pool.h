@@ -9,27 +9,151 @@
 #define SOCI_CONNECTION_POOL_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/connection-parameters.h"
+#include "soci/session-statistics.h"
 // std
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
 
 namespace soci
 {
 
 class session;
 
+// Options of a connection pool opening its sessions itself.
+struct connection_pool_options
+{
+    // Number of open sessions the pool tries to keep at all times.
+    std::size_t min_size = 0;
+
+    // Maximal number of sessions in the pool, must be positive.
+    std::size_t max_size = 1;
+
+    // Free sessions not used for longer than this are closed, unless there
+    // are only min_size open sessions left. Zero means never closing them.
+    std::chrono::milliseconds idle_timeout{0};
+
+    // Sessions not used for longer than this are checked using
+    // session::is_connected() when they're leased and reopened if necessary.
+    // Zero means never checking them.
+    std::chrono::milliseconds validation_interval{0};
+
+    // Interval between the runs of maintain() in the background thread
+    // created by the pool. Zero means not creating this thread at all.
+    std::chrono::milliseconds maintenance_interval{0};
+
+    // Function called after opening each session, e.g. to set up the session
+    // state or to warm up the server caches before the session is used.
+    std::function<void(session &)> warm_up;
+
+    // Statements prepared after opening each session, and calling warm_up,
+    // which can be retrieved using session::get_prepared_statement() with
+    // the corresponding key.
+    std::map<std::string, std::string> prepared_statements;
+
+    // If true, session::collect_statistics() is enabled for all sessions,
+    // allowing to retrieve their combined statistics using
+    // connection_pool::get_statistics().
+    bool collect_statistics = false;
+};
+
+// Priority of a lease request: waiting requests with higher priority are
+// always served before the ones with lower priority, while the requests with
+// the same priority are served in FIFO order.
+enum class lease_priority
+{
+    low,
+    normal,
+    high
+};
+
+// Snapshot of the connection pool statistics returned by get_stats().
+struct connection_pool_stats
+{
+    // Histogram of durations using logarithmic scale: the bucket with index
+    // 0 counts the durations less than 1us and the bucket with index N > 0
+    // the durations in [2^(N-1), 2^N) microseconds range, with the last
+    // bucket also counting all longer durations.
+    static constexpr std::size_t histogram_buckets = 32;
+    typedef std::array<std::uint64_t, histogram_buckets> histogram;
+
+    // Total number of sessions in the pool.
+    std::size_t size = 0;
+
+    // Number of currently leased and free sessions.
+    std::size_t in_use = 0;
+    std::size_t free = 0;
+
+    // Maximal number of sessions leased at the same time.
+    std::size_t high_water_mark = 0;
+
+    // Number of successful leases and of try_lease() calls which timed out.
+    std::uint64_t leases = 0;
+    std::uint64_t timeouts = 0;
+
+    // Time spent waiting for a session in lease() or try_lease().
+    histogram wait_time{};
+
+    // Time during which the sessions were leased.
+    histogram hold_time{};
+};
+
 class SOCI_DECL connection_pool
 {
 public:
     explicit connection_pool(std::size_t size);
+    connection_pool(connection_parameters const & parameters,
+                    connection_pool_options const & options);
     ~connection_pool();
 
+    std::size_t size() const;
+
+    // Return the number of currently leased sessions, this is much cheaper
+    // than using get_stats() if nothing else is needed.
+    std::size_t in_use() const;
+
     session & at(std::size_t pos);
 
     std::size_t lease();
     bool try_lease(std::size_t & pos, int timeout);
     void give_back(std::size_t pos);
 
+    // Lease an entry with the given priority, blocking until one becomes
+    // available for as long as necessary.
+    std::size_t lease(lease_priority priority);
+
+    // Lease an entry with the given priority, waiting until the specified
+    // time point at most. Returns false if no entry became available before
+    // the deadline. If it has already passed, this function doesn't wait at
+    // all and only succeeds if an entry is available immediately.
+    bool try_lease(std::size_t & pos, lease_priority priority,
+                   std::chrono::steady_clock::time_point deadline);
+
+    // Reserve the given number of sessions for the requests with the given
+    // or higher priority: the requests with lower priority can't lease them.
+    void set_reserved_capacity(lease_priority priority, std::size_t count);
+
+    // Close the idle sessions and open the new ones to have at least the
+    // minimal number of them, can only be used with the pool opening the
+    // sessions itself.
+    void maintain();
+
+    // Return the current statistics. Note that different fields are updated
+    // independently, so they may be slightly inconsistent with each other
+    // if the pool is used by other threads concurrently.
+    connection_pool_stats get_stats() const;
+
+    // Return the sum of the statistics of all the sessions of the pool, see
+    // session::get_statistics(), including at most the given number of the
+    // queries with the biggest total time across all of them.
+    session_statistics get_statistics(std::size_t topQueries = 10) const;
+
 private:
     struct connection_pool_impl;
     std::unique_ptr<connection_pool_impl> pimpl_;
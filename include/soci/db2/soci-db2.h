@@ -75,6 +75,35 @@ public:
 // (in string form as all options are strings currently).
 extern SOCI_DB2_DECL char const * db2_option_driver_complete;
 
+// Option allowing to continue executing bulk operations using vector use
+// elements after errors in some of the rows instead of throwing an exception.
+// It only provides the default value for all statements of the session, see
+// db2_statement_backend::set_continue_on_error().
+extern SOCI_DB2_DECL char const * db2_option_continue_on_error;
+
+// Diagnostic record returned by DB2 CLI for a single row of a bulk operation.
+struct db2_diag_record
+{
+    std::string sqlstate;
+    SQLINTEGER native_error_code = 0;
+    std::string message;
+};
+
+// Outcome of a bulk operation using vector use elements for a single row.
+struct db2_bulk_row_result
+{
+    // One of SQL_PARAM_XXX constants, e.g. SQL_PARAM_SUCCESS or SQL_PARAM_ERROR.
+    SQLUSMALLINT status = SQL_PARAM_UNUSED;
+
+    // Diagnostic records associated with this row, possibly empty.
+    std::vector<db2_diag_record> diagnostics;
+
+    bool succeeded() const
+    {
+        return status == SQL_PARAM_SUCCESS || status == SQL_PARAM_SUCCESS_WITH_INFO;
+    }
+};
+
 struct db2_statement_backend;
 
 struct SOCI_DB2_DECL db2_standard_into_type_backend : details::standard_into_type_backend
@@ -204,6 +233,28 @@ struct SOCI_DB2_DECL db2_statement_backend : details::statement_backend
     void describe_column(int colNum, db_type& dbtype, std::string& columnName) override;
     size_t column_size(int col);
 
+    int get_row_to_dump() const override { return error_row_; }
+
+    // By default, execute() throws if any row of a bulk operation fails. When
+    // this option is on, the rows are executed independently of each other,
+    // execute() only throws if the statement couldn't be executed at all and
+    // the rows which failed must be found using get_bulk_results().
+    void set_continue_on_error(bool continueOnError) { continueOnError_ = continueOnError; }
+    bool get_continue_on_error() const { return continueOnError_; }
+
+    // Return the results for all rows processed by the last bulk operation.
+    std::vector<db2_bulk_row_result> const& get_bulk_results() const { return bulkResults_; }
+
+    // Return the number of rows processed by the last bulk operation.
+    std::size_t get_bulk_rows_processed() const { return bulkResults_.size(); }
+
+    // Return the number of rows of the last bulk operation which failed.
+    std::size_t get_bulk_errors_count() const;
+
+    // Called by vector use elements to set up the per-row status array for
+    // the given number of rows.
+    void prepare_bulk_status(std::size_t rows);
+
     db2_standard_into_type_backend* make_into_type_backend() override;
     db2_standard_use_type_backend* make_use_type_backend() override;
     db2_vector_into_type_backend* make_vector_into_type_backend() override;
@@ -217,6 +268,34 @@ struct SOCI_DB2_DECL db2_statement_backend : details::statement_backend
     bool hasVectorUseElements;
     SQLUINTEGER numRowsFetched;
     details::db2::binding_method use_binding_method_;
+
+private:
+    // execute() helper filling bulkResults_ and error_row_ from the status
+    // array of a bulk operation and returning the number of successful rows.
+    std::size_t update_bulk_results();
+
+    // execute() helper assigning all diagnostic records associated with the
+    // individual rows to the corresponding elements of bulkResults_.
+    void collect_bulk_diagnostics();
+
+    // Number of rows and status of each of them for bulk operations: CLI
+    // keeps pointers to these variables, so they must be members.
+    SQLULEN paramsProcessed_ = 0;
+    std::vector<SQLUSMALLINT> paramStatus_;
+
+    // First row with the error for bulk operations or -1.
+    int error_row_ = -1;
+
+    // Number of successful rows if the last bulk operation partially failed
+    // or -1 if SQLRowCount() should be used.
+    long long rowsAffected_ = -1;
+
+    bool continueOnError_;
+
+    // True if SQL_ATTR_PARAMOPT_ATOMIC was set to SQL_ATOMIC_NO.
+    bool nonAtomic_ = false;
+
+    std::vector<db2_bulk_row_result> bulkResults_;
 };
 
 struct SOCI_DB2_DECL db2_rowid_backend : details::rowid_backend
@@ -273,6 +352,9 @@ struct SOCI_DB2_DECL db2_session_backend : details::session_backend
     bool autocommit;
     bool in_transaction;
 
+    // Default value of db2_statement_backend::get_continue_on_error().
+    bool continueOnError_;
+
     SQLHANDLE hEnv; /* Environment handle */
     SQLHANDLE hDbc; /* Connection handle */
 };
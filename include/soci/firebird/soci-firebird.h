@@ -20,6 +20,9 @@
 #include <soci/soci-backend.h>
 #include <ibase.h> // FireBird
 #include <cstdlib>
+#include <cstring>
+#include <list>
+#include <map>
 #include <vector>
 #include <string>
 #include <cstdint>
@@ -94,12 +97,53 @@ struct firebird_vector_into_type_backend : details::vector_into_type_backend
     firebird_statement_backend &statement_;
     virtual void exchangeData(std::size_t row);
 
+    // Check if the values can be stored directly in the vector storage when
+    // fetching the next rows, without the conversions done by exchangeData(),
+    // and remember its address if so. Must be called before each fetch, as
+    // the vector may have been modified since the previous one.
+    void prepareDirectFetch();
+
+    // Store the value of the current row directly in the vector if possible
+    // and return true or just return false if exchangeData() must be used.
+    bool exchangeDataDirect(std::size_t row)
+    {
+        switch (direct_)
+        {
+        case eDirectNone:
+            break;
+
+        case eDirectCopy:
+            std::memcpy(directData_ + row*directSize_, buf_, directSize_);
+            return true;
+
+        case eDirectString:
+            exchangeStringDirect(row);
+            return true;
+        }
+
+        return false;
+    }
+
     void *data_;
     details::exchange_type type_;
     int position_;
 
     char *buf_;
     short indISCHolder_;
+
+private:
+    void exchangeStringDirect(std::size_t row);
+
+    enum DirectKind { eDirectNone, eDirectCopy, eDirectString };
+    DirectKind direct_ = eDirectNone;
+
+    // Start of the vector data for eDirectCopy or the vector itself for
+    // eDirectString.
+    char *directData_ = nullptr;
+
+    // Size of the vector element for eDirectCopy or, for eDirectString, of
+    // the column if it is SQL_TEXT or 0 if it is SQL_VARYING.
+    std::size_t directSize_ = 0;
 };
 
 struct firebird_standard_use_type_backend : details::standard_use_type_backend
@@ -176,6 +220,15 @@ private:
     firebird_blob_backend *blob_;
 };
 
+// Prepared statement kept in firebird_session_backend statement cache.
+struct firebird_cached_statement
+{
+    isc_stmt_handle stmtp = 0;
+    XSQLDA *sqldap = nullptr;
+    XSQLDA *sqlda2p = nullptr;
+    std::map<std::string, int> names;
+};
+
 struct firebird_session_backend;
 struct SOCI_FIREBIRD_DECL firebird_statement_backend : details::statement_backend
 {
@@ -249,6 +302,25 @@ protected:
     bool procedure_;
 
 private:
+    // prepare() helper actually preparing the statement, sets isDDL_.
+    void prepare_statement(std::string const &query);
+
+    // Return the statement to the session cache or free it if it can't be
+    // cached.
+    void release_statement();
+
+    // Key of this statement in the session cache or empty if not cached.
+    std::string cacheKey_;
+
+    // Set by rewriteQuery() if the statement is a DDL one.
+    bool isDDL_ = false;
+
+    // execute() helper using Firebird 4 batch API to execute the statement
+    // with vector use elements in a single round trip. Returns false if the
+    // batch API is not available, in which case the rows must be executed
+    // one by one.
+    bool execute_batch(int rows);
+
     // Used during bulk operations to keep track of the row which potentially
     // resulted in an error.
     int current_row_ = -1;
@@ -327,6 +399,27 @@ struct SOCI_FIREBIRD_DECL firebird_session_backend : details::session_backend
 
     bool get_option_decimals_as_strings() { return decimals_as_strings_; }
 
+    // Return the maximal number of prepared statements kept in the cache or 0
+    // if the statement cache is not used.
+    std::size_t get_statement_cache_size() const { return stmtCacheSize_; }
+
+    // Return the number of statements currently in the cache.
+    std::size_t get_cached_statements_count() const { return stmtCache_.size(); }
+
+    // Remove the statement prepared for the given key from the cache and
+    // return it, if found.
+    bool take_cached_statement(std::string const & key,
+        firebird_cached_statement & stmt);
+
+    // Put the statement in the cache, taking ownership of it, and possibly
+    // freeing the least recently used statement to make room for it.
+    void cache_statement(std::string const & key,
+        firebird_cached_statement & stmt);
+
+    // Free all cached statements: this is needed before modifying any
+    // database objects used by them.
+    void clear_statement_cache();
+
     // Returns the pointer to the current transaction handle, starting a new
     // transaction if necessary.
     //
@@ -338,6 +431,12 @@ struct SOCI_FIREBIRD_DECL firebird_session_backend : details::session_backend
 private:
     isc_tr_handle trhp_;
     bool decimals_as_strings_;
+
+    // Cached statements, the most recently used first. This is a list and not
+    // a map because it is supposed to be small and the same query may be
+    // present more than once in it.
+    std::size_t stmtCacheSize_;
+    std::list<std::pair<std::string, firebird_cached_statement>> stmtCache_;
 };
 
 struct firebird_backend_factory : backend_factory
@@ -9,7 +9,9 @@
 #define SOCI_LOGGER_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/query-fingerprint.h"
 
+#include <chrono>
 #include <ostream>
 #include <vector>
 
@@ -26,6 +28,33 @@ struct SOCI_DECL query_parameter
     std::string value;
 };
 
+// Information about the outcome of executing a statement or fetching data
+// from it passed to logger_impl::end_execute() and end_fetch().
+struct SOCI_DECL query_end_info
+{
+    // Time taken by the operation, as measured by a monotonic clock.
+    std::chrono::steady_clock::duration duration{};
+
+    // Number of rows affected by a statement without any into elements, or -1
+    // if it's unknown or not applicable (always the case for fetch()).
+    long long affectedRows = -1;
+
+    // Number of rows retrieved into the bound variables.
+    std::size_t fetchedRows = 0;
+
+    // Number of round trips to the database server, or -1 if the backend
+    // doesn't provide this information.
+    int roundTrips = -1;
+
+    // True if the operation failed, i.e. threw an exception.
+    bool failed = false;
+
+    // Normalized form of the query which can be used as the key for grouping
+    // together the queries differing only in their literal values, never null
+    // when passed to logger_impl.
+    query_fingerprint const * fingerprint = nullptr;
+};
+
 // Allows to customize the logging of database operations performed by SOCI.
 //
 // To do it, derive your own class from logger_impl and override its pure
@@ -47,6 +76,17 @@ public:
     // Clears all currently logged query parameters
     virtual void clear_query_parameters();
 
+    // Override to return true to have end_execute() and end_fetch() called.
+    //
+    // This is only checked once, when the logger is created, and is false by
+    // default, so that the time is not measured if it's not needed.
+    virtual bool wants_query_end() const;
+
+    // Called after executing the given query or fetching data from it, even
+    // if the operation failed.
+    virtual void end_execute(std::string const & query, query_end_info const & info);
+    virtual void end_fetch(std::string const & query, query_end_info const & info);
+
     logger_impl * clone() const;
 
     // These methods are for compatibility only as they're used to implement
@@ -96,6 +136,18 @@ public:
 
     virtual void clear_query_parameters() { m_impl->clear_query_parameters(); }
 
+    bool wants_query_end() const { return m_wantsQueryEnd; }
+
+    void end_execute(std::string const & query, query_end_info const & info) const
+    {
+        m_impl->end_execute(query, info);
+    }
+
+    void end_fetch(std::string const & query, query_end_info const & info) const
+    {
+        m_impl->end_fetch(query, info);
+    }
+
     // Methods used for the implementation of session basic logging support.
     void set_stream(std::ostream * s) { m_impl->set_stream(s); }
     std::ostream * get_stream() const { return m_impl->get_stream(); }
@@ -104,6 +156,9 @@ public:
 
 private:
     logger_impl * m_impl;
+
+    // Cached result of m_impl->wants_query_end().
+    bool m_wantsQueryEnd;
 };
 
 } // namespace soci
@@ -169,6 +169,8 @@ struct SOCI_MYSQL_DECL mysql_statement_backend : details::statement_backend
     mysql_vector_into_type_backend * make_vector_into_type_backend() override;
     mysql_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    bool supports_lazy_row_conversion() const override { return true; }
+
     mysql_session_backend &session_;
 
     MYSQL_RES *result_;
@@ -16,6 +16,7 @@
 # define SOCI_ODBC_DECL SOCI_DECL_IMPORT
 #endif
 
+#include <string>
 #include <vector>
 #include <soci/soci-backend.h>
 #if defined(_MSC_VER) || defined(__MINGW32__)
@@ -67,6 +68,35 @@ constexpr int odbc_option_remember_completed = 0x100;
 // a pointer to HWND, either in decimal or hexadecimal form (with "0x" prefix).
 extern SOCI_ODBC_DECL char const * odbc_option_parent_window;
 
+// Option allowing to continue executing bulk operations using vector use
+// elements after errors in some of the rows instead of throwing an exception.
+// It only provides the default value for all statements of the session, see
+// odbc_statement_backend::set_continue_on_error().
+extern SOCI_ODBC_DECL char const * odbc_option_continue_on_error;
+
+// Diagnostic record returned by ODBC for a single row of a bulk operation.
+struct odbc_diag_record
+{
+    std::string sqlstate;
+    SQLINTEGER native_error_code = 0;
+    std::string message;
+};
+
+// Outcome of a bulk operation using vector use elements for a single row.
+struct odbc_bulk_row_result
+{
+    // One of SQL_PARAM_XXX constants, e.g. SQL_PARAM_SUCCESS or SQL_PARAM_ERROR.
+    SQLUSMALLINT status = SQL_PARAM_UNUSED;
+
+    // Diagnostic records associated with this row, possibly empty.
+    std::vector<odbc_diag_record> diagnostics;
+
+    bool succeeded() const
+    {
+        return status == SQL_PARAM_SUCCESS || status == SQL_PARAM_SUCCESS_WITH_INFO;
+    }
+};
+
 struct odbc_statement_backend;
 
 // Helper of into and use backends.
@@ -282,11 +312,28 @@ struct SOCI_ODBC_DECL odbc_statement_backend : details::statement_backend
     // helper for defining into vector<string>
     std::size_t column_size(int position);
 
+    // By default, execute() throws if any row of a bulk operation fails. When
+    // this option is on, it only throws if the statement couldn't be executed
+    // at all and the rows which failed must be found using get_bulk_results().
+    void set_continue_on_error(bool continueOnError) { continueOnError_ = continueOnError; }
+    bool get_continue_on_error() const { return continueOnError_; }
+
+    // Return the results for all rows processed by the last bulk operation.
+    std::vector<odbc_bulk_row_result> const& get_bulk_results() const { return bulkResults_; }
+
+    // Return the number of rows processed by the last bulk operation.
+    std::size_t get_bulk_rows_processed() const { return bulkResults_.size(); }
+
+    // Return the number of rows of the last bulk operation which failed.
+    std::size_t get_bulk_errors_count() const;
+
     odbc_standard_into_type_backend * make_into_type_backend() override;
     odbc_standard_use_type_backend * make_use_type_backend() override;
     odbc_vector_into_type_backend * make_vector_into_type_backend() override;
     odbc_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    bool supports_lazy_row_conversion() const override { return true; }
+
     odbc_session_backend &session_;
     SQLHSTMT hstmt_;
     SQLULEN numRowsFetched_;
@@ -307,8 +354,21 @@ private:
     // fetch() helper wrapping SQLFetch() call for the given range of rows.
     exec_fetch_result do_fetch(int beginRow, int endRow);
 
+    // execute() helper filling bulkResults_ and error_row_ from the status
+    // array of a bulk operation and returning the number of successful rows.
+    std::size_t update_bulk_results(std::vector<SQLUSMALLINT> const& status,
+                                    SQLULEN rowsProcessed);
+
+    // execute() helper assigning all diagnostic records associated with the
+    // individual rows to the corresponding elements of bulkResults_.
+    void collect_bulk_diagnostics();
+
     // First row with the error for bulk operations or -1.
     int error_row_ = -1;
+
+    bool continueOnError_;
+
+    std::vector<odbc_bulk_row_result> bulkResults_;
 };
 
 struct SOCI_ODBC_DECL odbc_rowid_backend : details::rowid_backend
@@ -415,6 +475,9 @@ struct SOCI_ODBC_DECL odbc_session_backend : details::session_backend
 
     std::string connection_string_;
 
+    // Default value of odbc_statement_backend::get_continue_on_error().
+    bool continueOnError_;
+
 private:
     mutable database_product product_;
 };
@@ -18,6 +18,8 @@
 
 #include <soci/soci-backend.h>
 #include <oci.h> // OCI
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -40,6 +42,17 @@ public:
     int err_num_;
 };
 
+// Error which occurred for a single row of a bulk DML operation.
+struct oracle_batch_error
+{
+    // 0-based index of the row in the vector use elements.
+    ub4 row = 0;
+
+    // Oracle error code, e.g. 1 for ORA-00001, and the error message.
+    int error_code = 0;
+    std::string message;
+};
+
 
 struct oracle_statement_backend;
 struct oracle_standard_into_type_backend : details::standard_into_type_backend
@@ -213,6 +226,7 @@ struct oracle_session_backend;
 struct SOCI_ORACLE_DECL oracle_statement_backend : details::statement_backend
 {
     oracle_statement_backend(oracle_session_backend &session);
+    ~oracle_statement_backend() override;
 
     void alloc() override;
     void clean_up() override;
@@ -237,6 +251,24 @@ struct SOCI_ORACLE_DECL oracle_statement_backend : details::statement_backend
     // helper for defining into vector<string>
     std::size_t column_size(int position);
 
+    // Set the number of rows or the amount of memory (in bytes) to prefetch
+    // when executing the query or fetching from it, overriding the defaults
+    // inherited from the session. These functions can be called either before
+    // or after preparing the statement and 0 means to use OCI default value.
+    void set_prefetch_rows(ub4 rows);
+    void set_prefetch_memory(ub4 bytes);
+
+    // By default, execute() throws if any row of a bulk INSERT, UPDATE or
+    // DELETE fails. When this option is on, the errors for the individual
+    // rows don't result in exceptions and must be retrieved using
+    // get_batch_errors() instead.
+    void set_continue_on_error(bool continueOnError) { continueOnError_ = continueOnError; }
+    bool get_continue_on_error() const { return continueOnError_; }
+
+    // Return the errors for all rows which failed during the last execution
+    // of a bulk DML statement, in the order of rows.
+    std::vector<oracle_batch_error> const& get_batch_errors() const { return batchErrors_; }
+
     oracle_standard_into_type_backend * make_into_type_backend() override;
     oracle_standard_use_type_backend * make_use_type_backend() override;
     oracle_vector_into_type_backend * make_vector_into_type_backend() override;
@@ -255,8 +287,29 @@ private:
     template <typename T>
     T get_statement_attr(int attr) const;
 
+    // Wrapper for OCIAttrSet(), throws on error.
+    void set_statement_attr(ub4 value, int attr);
+
+    // Apply the prefetch options, if any, to the prepared statement.
+    void apply_prefetch_options();
+
+    ub4 prefetchRows_;
+    ub4 prefetchMemory_;
+
+    // True if stmtp_ was returned by OCIStmtPrepare2(), which happens when
+    // the statement cache is used, and so must be freed using OCIStmtRelease().
+    bool fromStmtCache_ = false;
+
+    // execute() helper filling batchErrors_ using the errors returned by
+    // OCI for a statement executed in OCI_BATCH_ERRORS mode.
+    void collect_batch_errors();
+
     // First row with the error for bulk operations or -1.
     int error_row_ = -1;
+
+    bool continueOnError_;
+
+    std::vector<oracle_batch_error> batchErrors_;
 };
 
 struct SOCI_ORACLE_DECL oracle_rowid_backend : details::rowid_backend
@@ -318,6 +371,59 @@ private:
     bool initialized_;
 };
 
+// OCI session pool which can be shared by several sessions, see the "Session
+// pool" section of the documentation.
+class SOCI_ORACLE_DECL oracle_session_pool
+{
+public:
+    oracle_session_pool(std::string const & serviceName,
+        std::string const & userName,
+        std::string const & password,
+        ub4 minSessions,
+        ub4 maxSessions,
+        ub4 increment,
+        ub2 charset = 0,
+        ub2 ncharset = 0,
+        ub4 stmtCacheSize = 0);
+
+    ~oracle_session_pool();
+
+    // Return the existing pool with the same parameters or create a new one.
+    // The pool is destroyed when the last session using it is closed.
+    static std::shared_ptr<oracle_session_pool> get(
+        std::string const & serviceName,
+        std::string const & userName,
+        std::string const & password,
+        ub4 minSessions,
+        ub4 maxSessions,
+        ub4 increment,
+        ub2 charset = 0,
+        ub2 ncharset = 0,
+        ub4 stmtCacheSize = 0);
+
+    // Return the number of the sessions currently open in the pool and the
+    // number of them currently acquired by soci sessions.
+    ub4 get_open_count() const;
+    ub4 get_busy_count() const;
+
+    ub4 get_statement_cache_size() const { return stmtCacheSize_; }
+
+    OCIEnv *envhp_;
+    OCIError *errhp_;
+    OCISPool *spoolhp_;
+    OraText *poolName_;
+    ub4 poolNameLen_;
+
+private:
+    ub4 get_pool_attr(int attr) const;
+
+    void clean_up();
+
+    ub4 stmtCacheSize_;
+
+    SOCI_NOT_COPYABLE(oracle_session_pool)
+};
+
 struct SOCI_ORACLE_DECL oracle_session_backend : details::session_backend
 {
     oracle_session_backend(std::string const & serviceName,
@@ -326,7 +432,15 @@ struct SOCI_ORACLE_DECL oracle_session_backend : details::session_backend
         int mode,
         bool decimals_as_strings = false,
         ub2 charset = 0,
-        ub2 ncharset = 0);
+        ub2 ncharset = 0,
+        ub4 stmtCacheSize = 0);
+
+    // Create a session using the given OCI session pool: in this case the
+    // session is only acquired from the pool when it is used for the first
+    // time and is released back to it when this session is given back to
+    // connection_pool.
+    oracle_session_backend(std::shared_ptr<oracle_session_pool> const & pool,
+        bool decimals_as_strings = false);
 
     ~oracle_session_backend() override;
 
@@ -454,12 +568,33 @@ struct SOCI_ORACLE_DECL oracle_session_backend : details::session_backend
 
     void clean_up();
 
+    void on_pool_give_back() override;
+    bool supports_pool_prepared_statements() const override { return !pool_; }
+
     oracle_statement_backend * make_statement_backend() override;
     oracle_rowid_backend * make_rowid_backend() override;
     oracle_blob_backend * make_blob_backend() override;
 
+    // Return the OCI session pool used by this session or null if none.
+    oracle_session_pool * get_session_pool() const { return pool_.get(); }
+
     bool get_option_decimals_as_strings() { return decimals_as_strings_; }
 
+    // Return the size of OCI statement cache, 0 if it is not used.
+    ub4 get_statement_cache_size() const { return stmtCacheSize_; }
+
+    // Set the default prefetch options for the statements created after
+    // calling these functions, see oracle_statement_backend::set_prefetch_rows().
+    void set_prefetch_rows(ub4 rows) { prefetchRows_ = rows; }
+    ub4 get_prefetch_rows() const { return prefetchRows_; }
+    void set_prefetch_memory(ub4 bytes) { prefetchMemory_ = bytes; }
+    ub4 get_prefetch_memory() const { return prefetchMemory_; }
+
+    // Set the default value of oracle_statement_backend::set_continue_on_error()
+    // for the statements created after calling this function.
+    void set_continue_on_error(bool continueOnError) { continueOnError_ = continueOnError; }
+    bool get_continue_on_error() const { return continueOnError_; }
+
     // Return either SQLT_FLT or SQLT_BDOUBLE as the type to use when binding
     // values of C type "double" (the latter is preferable but might not be
     // always available).
@@ -471,6 +606,24 @@ struct SOCI_ORACLE_DECL oracle_session_backend : details::session_backend
     OCISvcCtx *svchp_;
     OCISession *usrhp_;
     bool decimals_as_strings_;
+
+    // Number of existing statements of this session: the pooled OCI session
+    // is not released while there are any, as their handles are tied to it.
+    std::size_t statementsCount_ = 0;
+
+private:
+    // Get the session from the pool if we use one and don't have it yet.
+    void acquire_pooled_session();
+
+    // Give the session back to the pool, if we have it.
+    void release_pooled_session();
+
+    std::shared_ptr<oracle_session_pool> pool_;
+
+    ub4 stmtCacheSize_;
+    ub4 prefetchRows_ = 0;
+    ub4 prefetchMemory_ = 0;
+    bool continueOnError_ = false;
 };
 
 struct oracle_backend_factory : backend_factory
@@ -271,6 +271,7 @@ struct SOCI_POSTGRESQL_DECL postgresql_statement_backend : details::statement_ba
     int get_number_of_rows() override;
     std::string get_parameter_name(int index) const override;
     int get_row_to_dump() const override { return current_row_; }
+    int get_round_trips() const override { return roundTrips_; }
 
     std::string rewrite_for_procedure_call(std::string const & query) override;
 
@@ -284,6 +285,8 @@ struct SOCI_POSTGRESQL_DECL postgresql_statement_backend : details::statement_ba
     postgresql_vector_into_type_backend * make_vector_into_type_backend() override;
     postgresql_vector_use_type_backend * make_vector_use_type_backend() override;
 
+    bool supports_lazy_row_conversion() const override { return true; }
+
     postgresql_session_backend & session_;
 
     bool single_row_mode_;
@@ -330,6 +333,9 @@ private:
 
     // Current row during a bulk operation or -1 if it's not in progress.
     int current_row_ = -1;
+
+    // Number of round trips made by the last execute() or fetch().
+    int roundTrips_ = 0;
 };
 
 struct SOCI_POSTGRESQL_DECL postgresql_rowid_backend : details::rowid_backend
@@ -0,0 +1,103 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_QUERY_FINGERPRINT_H_INCLUDED
+#define SOCI_QUERY_FINGERPRINT_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/soci-defs.h"
+// std
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace soci
+{
+
+// Normalized form of a query which can be used to group together the queries
+// differing only in the values of their literals.
+//
+// The normalized query has all string and numeric literals, including the
+// unary signs of the latter, replaced with "?", the lists consisting only of
+// literals, e.g. "in (1, 2, 3)", replaced with "(...)" and the comments
+// removed. Whitespace is removed around punctuation and collapsed into a single
+// space between words, e.g. "where id = -1" becomes "where id=?". The
+// placeholders and identifiers are preserved.
+//
+// The database engine is used to recognize its specific quoting rules, e.g.
+// double quotes delimiting strings in MySQL or dollar-quoted strings in
+// PostgreSQL.
+//
+// The query is processed in a single pass and no memory is allocated unless
+// the normalized query is longer than inline_size.
+class SOCI_DECL query_fingerprint
+{
+public:
+    static constexpr std::size_t inline_size = 256;
+
+    // Default constructor creates an empty fingerprint.
+    query_fingerprint() : size_(0), hash_(offset_basis) {}
+
+    explicit query_fingerprint(std::string const & query,
+                               database_engine engine = database_engine::unknown);
+
+    // 64-bit FNV-1a hash of the normalized query.
+    std::uint64_t hash() const { return hash_; }
+
+    // The normalized query, not NUL-terminated.
+    char const * data() const { return size_ > inline_size ? long_.data() : inline_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    std::string str() const { return std::string(data(), size_); }
+
+    bool operator==(query_fingerprint const & other) const
+    {
+        return hash_ == other.hash_ && size_ == other.size_ &&
+                std::memcmp(data(), other.data(), size_) == 0;
+    }
+
+    bool operator!=(query_fingerprint const & other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    static constexpr std::uint64_t offset_basis = 14695981039346656037ULL;
+    static constexpr std::uint64_t prime = 1099511628211ULL;
+
+    void append(char c);
+    void append(char const * s);
+    void truncate(std::size_t size, std::uint64_t hash);
+
+    // The first inline_size characters are always stored in inline_, the
+    // whole string is only copied to long_ if it becomes longer than that.
+    char inline_[inline_size];
+    std::string long_;
+
+    std::size_t size_;
+    std::uint64_t hash_;
+};
+
+} // namespace soci
+
+namespace std
+{
+
+template <>
+struct hash<soci::query_fingerprint>
+{
+    std::size_t operator()(soci::query_fingerprint const & f) const
+    {
+        return static_cast<std::size_t>(f.hash());
+    }
+};
+
+} // namespace std
+
+#endif // SOCI_QUERY_FINGERPRINT_H_INCLUDED
@@ -0,0 +1,87 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_ROUTING_POOL_H_INCLUDED
+#define SOCI_ROUTING_POOL_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/connection-parameters.h"
+#include "soci/connection-pool.h"
+// std
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace soci
+{
+
+// What a session leased from routing_pool is going to be used for.
+enum class access_intent
+{
+    read,
+    write
+};
+
+// Options of routing_pool.
+struct routing_pool_options
+{
+    // Options used for the primary pool and for each of the replica pools.
+    connection_pool_options pool;
+
+    // Time during which a replica is not used after failing to open a
+    // connection to it or after calling eject_replica() for it.
+    std::chrono::milliseconds ejection_time{std::chrono::seconds(30)};
+
+    // Whether reads can be served by the primary if no replica is available
+    // without waiting or if all of them are ejected. If false, reads wait for
+    // a replica to become available and throw if all of them are ejected.
+    bool read_from_primary = true;
+
+    // Maximal time to wait for a session of a busy replica before checking
+    // if a session of another replica or of the primary became free.
+    std::chrono::milliseconds wait_interval{100};
+};
+
+// Pool routing the sessions used for writing to the primary database and
+// the ones used for reading to its replicas, while balancing the load
+// between them.
+class SOCI_DECL routing_pool
+{
+public:
+    routing_pool(connection_parameters const & primary,
+                 std::vector<connection_parameters> const & replicas,
+                 routing_pool_options const & options = routing_pool_options());
+    ~routing_pool();
+
+    connection_pool & primary();
+
+    std::size_t replicas_count() const;
+    connection_pool & replica(std::size_t n);
+
+    // Lease a session suitable for the given intent, blocking until one is
+    // available, and return the pool it belongs to. The session at the
+    // position returned in pos must be given back to this pool later.
+    //
+    // Writes always use the primary, while reads use the non-ejected replica
+    // with the least number of sessions currently leased.
+    connection_pool & lease(access_intent intent, std::size_t & pos);
+
+    // Don't use the given replica for ejection_time from now on, e.g. because
+    // the application detected that its connection was broken.
+    void eject_replica(std::size_t n);
+    bool is_replica_ejected(std::size_t n) const;
+
+private:
+    struct routing_pool_impl;
+    std::unique_ptr<routing_pool_impl> pimpl_;
+
+    SOCI_NOT_COPYABLE(routing_pool)
+};
+
+}
+
+#endif // SOCI_ROUTING_POOL_H_INCLUDED
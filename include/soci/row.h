@@ -15,20 +15,28 @@
 #include "soci/type-conversion.h"
 // std
 #include <cstddef>
-#include <map>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace soci
 {
 
+namespace details
+{
+
+class statement_impl;
+
+} // namespace details
+
 class SOCI_DECL column_properties
 {
     // use getters/setters in case we want to make some
     // of the getters lazy in the future
 public:
 
-    std::string get_name() const { return name_; }
+    std::string const& get_name() const { return name_; }
     // DEPRECATED. USE get_db_type() INSTEAD.
     data_type get_data_type() const { return dataType_; }
     db_type get_db_type() const { return dbType_; }
@@ -45,14 +53,38 @@ private:
     db_type dbType_;
 };
 
+// Lightweight handle for a column of a row, which can be obtained once from
+// the column name using row::get_column_ref() and then used to access the
+// column values without looking up its name every time. It remains valid for
+// as long as the row columns don't change, which is only checked in the debug
+// builds, e.g. it can be used for all rows of the same rowset.
+class column_ref
+{
+public:
+    column_ref() : pos_(0), shape_(0) {}
+
+    std::size_t get_position() const { return pos_; }
+
+private:
+    friend class row;
+    friend class values;
+
+    column_ref(std::size_t pos, std::size_t shape) : pos_(pos), shape_(shape) {}
+
+    std::size_t pos_;
+
+    // Hash of the columns of the row this reference was created for.
+    std::size_t shape_;
+};
+
 class SOCI_DECL row
 {
 public:
     row();
     ~row();
 
-    row(row &&other) = default;
-    row &operator=(row &&other) = default;
+    row(row &&other);
+    row &operator=(row &&other);
 
     void uppercase_column_names(bool forceToUpper);
     void add_properties(column_properties const& cp);
@@ -62,27 +94,70 @@ public:
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const& name) const;
 
-    template <typename T>
-    inline void add_holder(T* t, indicator* ind)
+    // These functions are used by the statement to allocate the storage for
+    // the values of the columns of the given types, which must be done before
+    // adding the holders for them, and then construct the values in it.
+    void reserve_holders(std::vector<db_type> const& types);
+
+    template <typename T, typename... Args>
+    void add_holder(T*& t, indicator*& ind, Args&&... args)
     {
+        std::size_t const offset = align_storage_offset(alignof(T));
+        if (offset + sizeof(T) > storage_.size() * sizeof(storage_unit) ||
+                indicators_.size() == indicators_.capacity())
+        {
+            throw soci_error("Row storage must be reserved before adding holders.");
+        }
+
+        t = new (reinterpret_cast<char*>(storage_.data()) + offset)
+                T(std::forward<Args>(args)...);
+        storageUsed_ = offset + sizeof(T);
+
         holders_.push_back(details::holder::make_holder(t));
-        indicators_.push_back(ind);
+        indicators_.push_back(i_ok);
+        ind = &indicators_.back();
     }
 
     column_properties const& get_properties(std::size_t pos) const;
     column_properties const& get_properties(std::string const& name) const;
 
+    // Throws if there is no column with the given name.
+    column_ref get_column_ref(std::string const& name) const
+    {
+        return column_ref(find_column(name), shape_);
+    }
+
+    indicator get_indicator(column_ref const& col) const
+    {
+        check_shape(col);
+        return get_indicator(col.pos_);
+    }
+
+    column_properties const& get_properties(column_ref const& col) const
+    {
+        check_shape(col);
+        return get_properties(col.pos_);
+    }
+
+    // These functions are used by the statement only when the lazy row
+    // conversion is enabled: in this case, the values of the columns are
+    // only retrieved from the statement when they are accessed.
+    void set_lazy_statement(details::statement_impl* st);
+    void reset_lazy_columns(bool gotData);
+    void detach_lazy_statement();
+
     template <typename T>
     T get(std::size_t pos) const
     {
         typedef typename type_conversion<T>::base_type base_type;
         static_assert(details::can_use_from_base<type_conversion<T>>(),
                 "Can't use row::get() with this type (not convertible/copy-assignable from base_type) - did you mean to use move_as?");
+        load(pos);
         base_type const& baseVal =
-            holders_.at(pos)->get<base_type>(details::value_cast_tag{});
+            holders_.at(pos).get<base_type>(details::value_cast_tag{});
 
         T ret;
-        type_conversion<T>::from_base(baseVal, *indicators_.at(pos), ret);
+        type_conversion<T>::from_base(baseVal, indicators_.at(pos), ret);
         return ret;
     }
 
@@ -92,11 +167,12 @@ public:
         typedef typename type_conversion<T>::base_type base_type;
         static_assert(details::can_use_move_from_base<T, base_type>(),
                 "row::move_as() can only be called with types that can be instantiated from a base type rvalue reference");
+        load(pos);
         base_type & baseVal =
-            holders_.at(pos)->get<base_type>(details::value_reference_tag{});
+            holders_.at(pos).get<base_type>(details::value_reference_tag{});
 
         T ret;
-        type_conversion<T>::move_from_base(baseVal, *indicators_.at(pos), ret);
+        type_conversion<T>::move_from_base(baseVal, indicators_.at(pos), ret);
 
         // Re-initialize the holder in order to be able to use this row object
         // for binding to another data set
@@ -108,7 +184,8 @@ public:
     template <typename T>
     T get(std::size_t pos, T const &nullValue) const
     {
-        if (i_null == *indicators_.at(pos))
+        load(pos);
+        if (i_null == indicators_.at(pos))
         {
             return nullValue;
         }
@@ -119,7 +196,8 @@ public:
     template <typename T>
     T move_as(std::size_t pos, T const &nullValue) const
     {
-        if (i_null == *indicators_.at(pos))
+        load(pos);
+        if (i_null == indicators_.at(pos))
         {
             return nullValue;
         }
@@ -146,7 +224,8 @@ public:
     {
         std::size_t const pos = find_column(name);
 
-        if (i_null == *indicators_[pos])
+        load(pos);
+        if (i_null == indicators_[pos])
         {
             return nullValue;
         }
@@ -159,7 +238,8 @@ public:
     {
         std::size_t const pos = find_column(name);
 
-        if (i_null == *indicators_[pos])
+        load(pos);
+        if (i_null == indicators_[pos])
         {
             return nullValue;
         }
@@ -167,6 +247,20 @@ public:
         return move_as<T>(pos);
     }
 
+    template <typename T>
+    T get(column_ref const& col) const
+    {
+        check_shape(col);
+        return get<T>(col.pos_);
+    }
+
+    template <typename T>
+    T get(column_ref const& col, T const &nullValue) const
+    {
+        check_shape(col);
+        return get<T>(col.pos_, nullValue);
+    }
+
     template <typename T>
     row const& operator>>(T& value) const
     {
@@ -190,13 +284,68 @@ private:
 
     std::size_t find_column(std::string const& name) const;
 
+    void add_to_index(std::size_t pos);
+
+    void check_shape(column_ref const& col) const
+    {
+#ifndef NDEBUG
+        if (col.shape_ != shape_)
+        {
+            throw soci_error("Column reference used with a row with different columns.");
+        }
+#else
+        (void)col;
+#endif
+    }
+
+    std::size_t align_storage_offset(std::size_t alignment) const
+    {
+        return (storageUsed_ + alignment - 1) / alignment * alignment;
+    }
+
+    enum lazy_column_state
+    {
+        lazy_column_loaded,
+        lazy_column_pending,
+        lazy_column_unavailable
+    };
+
+    // Retrieve the value of the column from the statement if necessary.
+    void load(std::size_t pos) const
+    {
+        if (pos < lazyStates_.size() && lazyStates_[pos] != lazy_column_loaded)
+        {
+            do_load(pos);
+        }
+    }
+
+    void do_load(std::size_t pos) const;
+
     std::vector<column_properties> columns_;
-    std::vector<details::holder*> holders_;
-    std::vector<indicator*> indicators_;
-    std::map<std::string, std::size_t> index_;
+    std::vector<details::holder> holders_;
+    // Mutable because type_conversion<T>::from_base() takes a non-const
+    // indicator reference.
+    mutable std::vector<indicator> indicators_;
+
+    // Flat hash table of column positions indexed by their names, using
+    // linear probing: each element contains either the column position plus
+    // one or 0 for an empty slot and the size is always a power of 2.
+    std::vector<std::size_t> index_;
+
+    // Hash of the names and types of all columns.
+    std::size_t shape_;
+
+    // All column values are stored in this buffer, which is reused when the
+    // row is described again, e.g. when the statement is executed again.
+    typedef std::max_align_t storage_unit;
+    std::vector<storage_unit> storage_;
+    std::size_t storageUsed_;
 
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
+
+    details::statement_impl* lazyStatement_;
+    mutable std::vector<lazy_column_state> lazyStates_;
 };
 
 template <>
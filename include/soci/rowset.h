@@ -11,12 +11,137 @@
 #include "soci/soci-platform.h"
 #include "soci/statement.h"
 // std
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace soci
 {
 
+//
+// Option for rowset constructor specifying the number of rows to fetch from
+// the database at once.
+//
+class prefetch
+{
+public:
+    explicit prefetch(std::size_t rows) : rows_(rows) {}
+
+    std::size_t get_rows() const { return rows_; }
+
+private:
+    std::size_t rows_;
+};
+
+namespace details
+{
+
+//
+// Batch of rows fetched at once by the rowset created with prefetch option.
+//
+template <typename T>
+class rowset_batch
+{
+public:
+    explicit rowset_batch(std::size_t size)
+        : rows_(size), next_(0)
+    {}
+
+    // Must be called before executing the statement.
+    void bind(statement & st)
+    {
+        st.exchange_for_rowset(into(rows_));
+    }
+
+    // Return the next row, fetching the next batch if necessary, or null
+    // pointer if there are no more rows.
+    T * next(statement & st)
+    {
+        if (next_ == rows_.size())
+        {
+            if (rows_.empty() || st.fetch() == false)
+            {
+                return nullptr;
+            }
+
+            next_ = 0;
+        }
+
+        return &rows_[next_++];
+    }
+
+private:
+    std::vector<T> rows_;
+    std::size_t next_;
+}; // class rowset_batch
+
+//
+// Batch of tuples, using a separate vector for each of the tuple elements.
+//
+template <typename... Ts>
+class rowset_batch<std::tuple<Ts...> >
+{
+public:
+    static_assert(sizeof...(Ts) != 0, "rowset of empty tuples is not allowed");
+
+    explicit rowset_batch(std::size_t size)
+        : columns_(std::vector<Ts>(size)...), next_(0)
+    {}
+
+    // Must be called before executing the statement.
+    void bind(statement & st)
+    {
+        bind(st, index_sequence());
+    }
+
+    // Return the next row, fetching the next batch if necessary, or null
+    // pointer if there are no more rows.
+    std::tuple<Ts...> * next(statement & st)
+    {
+        if (next_ == std::get<0>(columns_).size())
+        {
+            if (std::get<0>(columns_).empty() || st.fetch() == false)
+            {
+                return nullptr;
+            }
+
+            next_ = 0;
+        }
+
+        get_row(index_sequence());
+        ++next_;
+
+        return &row_;
+    }
+
+private:
+    typedef std::index_sequence_for<Ts...> index_sequence;
+
+    template <std::size_t... I>
+    void bind(statement & st, std::index_sequence<I...>)
+    {
+        st.exchange_for_rowset(into(std::get<I>(columns_))...);
+    }
+
+    template <std::size_t... I>
+    void get_row(std::index_sequence<I...>)
+    {
+        int dummy[] = { 0,
+            (std::get<I>(row_) = std::move(std::get<I>(columns_)[next_]), 0)... };
+        (void)dummy;
+    }
+
+    std::tuple<std::vector<Ts>...> columns_;
+    std::tuple<Ts...> row_;
+    std::size_t next_;
+}; // class rowset_batch<std::tuple>
+
+} // namespace details
+
 //
 // rowset iterator of input category.
 //
@@ -36,16 +161,22 @@ public:
     // Constructors
 
     rowset_iterator()
-        : st_(0), define_(0)
+        : st_(0), define_(0), batch_(0)
     {}
 
     rowset_iterator(statement & st, T & define)
-        : st_(&st), define_(&define)
+        : st_(&st), define_(&define), batch_(0)
     {
         // Fetch first row to properly initialize iterator
         ++(*this);
     }
 
+    rowset_iterator(statement & st, details::rowset_batch<T> & batch)
+        : st_(&st), define_(0), batch_(&batch)
+    {
+        ++(*this);
+    }
+
     // Access operators
 
     reference operator*() const
@@ -62,9 +193,19 @@ public:
 
     rowset_iterator & operator++()
     {
-        // Fetch next row from dataset
+        // Fetch next row from dataset, or just take it from the batch, if we
+        // have any rows remaining in it
 
-        if (st_->fetch() == false)
+        if (batch_)
+        {
+            define_ = batch_->next(*st_);
+            if (define_ == 0)
+            {
+                st_ = 0;
+                batch_ = 0;
+            }
+        }
+        else if (st_->fetch() == false)
         {
             // Set iterator to non-derefencable state (pass-the-end)
             st_ = 0;
@@ -98,6 +239,7 @@ private:
 
     statement * st_;
     T * define_;
+    details::rowset_batch<T> * batch_;
 
 }; // class rowset_iterator
 
@@ -126,6 +268,20 @@ public:
         st_->execute();
     }
 
+    rowset_impl(details::prepare_temp_type const & prep, prefetch const & p)
+        : refs_(1), st_(new statement(prep)),
+          batch_(new rowset_batch<T>(p.get_rows() ? p.get_rows() : 1))
+    {
+        static_assert(!std::is_same<T, row>::value,
+                      "prefetch can't be used with rowset<row>, "
+                      "use column_batch to fetch dynamic rows in batches");
+
+        batch_->bind(*st_);
+
+        // Fetch the first batch immediately.
+        st_->execute(true);
+    }
+
     void incRef()
     {
         ++refs_;
@@ -142,7 +298,12 @@ public:
     iterator begin() const
     {
         // No ownership transfer occurs here. Empty rowset doesn't have any valid begin iterator.
-        return st_ ? iterator(*st_, *define_) : iterator();
+        if (!st_)
+        {
+            return iterator();
+        }
+
+        return batch_ ? iterator(*st_, *batch_) : iterator(*st_, *define_);
     }
 
     iterator end() const
@@ -156,6 +317,7 @@ private:
 
     const std::unique_ptr<statement> st_;
     const std::unique_ptr<T> define_;
+    const std::unique_ptr<rowset_batch<T>> batch_;
     SOCI_NOT_COPYABLE(rowset_impl)
 }; // class rowset_impl
 
@@ -182,6 +344,14 @@ public:
     {
     }
 
+    // fetch the given number of rows at once instead of fetching them one by
+    // one, this only works for the types which can be used with into vectors
+    // and for tuples of such types
+    rowset(details::prepare_temp_type const& prep, prefetch const& p)
+        : pimpl_(new details::rowset_impl<T>(prep, p))
+    {
+    }
+
     rowset(rowset const & other)
         : pimpl_(other.pimpl_)
     {
@@ -0,0 +1,83 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_SESSION_STATISTICS_H_INCLUDED
+#define SOCI_SESSION_STATISTICS_H_INCLUDED
+
+#include "soci/soci-platform.h"
+// std
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+// Statistics about all the executions of the queries with the same
+// fingerprint, i.e. differing only in their literal values.
+struct query_statistics
+{
+    // Normalized query and its hash, see query_fingerprint.
+    std::string query;
+    std::uint64_t hash = 0;
+
+    // Number of times the query was executed and how many of these
+    // executions failed.
+    std::uint64_t executions = 0;
+    std::uint64_t errors = 0;
+
+    // Total number of rows fetched from the query or affected by it.
+    std::uint64_t rows = 0;
+
+    // Total time spent executing the query and fetching data from it.
+    std::chrono::nanoseconds total_time{0};
+};
+
+// Snapshot of the statistics returned by session::get_statistics() and
+// connection_pool::get_statistics().
+struct SOCI_DECL session_statistics
+{
+    // Number of statements prepared and executed, including the failed ones.
+    std::uint64_t statements_prepared = 0;
+    std::uint64_t statements_executed = 0;
+
+    // Number of statements returned by session::get_prepared_statement()
+    // instead of being prepared again.
+    std::uint64_t cache_hits = 0;
+
+    // Number of rows fetched into the bound variables.
+    std::uint64_t rows_fetched = 0;
+
+    // Number of rows inserted, updated or deleted by the statements without
+    // any into elements, if the backend provides it.
+    std::uint64_t rows_affected = 0;
+
+    // Time spent in the backend calls executing the statements and fetching
+    // data from them and the rest of the time spent in SOCI itself, mostly
+    // converting the data between the database and C++ types.
+    std::chrono::nanoseconds backend_time{0};
+    std::chrono::nanoseconds conversion_time{0};
+
+    // Number of exceptions thrown by the statements.
+    std::uint64_t exceptions = 0;
+
+    // Statistics of the individual queries, sorted by their total time in
+    // decreasing order.
+    std::vector<query_statistics> top_queries;
+
+    // Add the statistics of another session to these ones, merging the
+    // statistics of the same queries.
+    session_statistics & operator+=(session_statistics const & other);
+
+    // Keep only the given number of the queries with the biggest total time.
+    void keep_top_queries(std::size_t count);
+};
+
+} // namespace soci
+
+#endif // SOCI_SESSION_STATISTICS_H_INCLUDED
@@ -15,6 +15,8 @@
 #include "soci/connection-parameters.h"
 #include "soci/logger.h"
 #include "soci/log-context.h"
+#include "soci/session-statistics.h"
+#include "soci/use-type.h"
 
 // std
 #include <cstddef>
@@ -24,11 +26,14 @@
 #include <sstream>
 #include <string>
 #include <forward_list>
+#include <map>
 #include <type_traits>
+#include <vector>
 
 namespace soci
 {
 class values;
+class statement;
 class backend_factory;
 struct schema_table_name;
 
@@ -37,12 +42,16 @@ namespace details
 
 class session_backend;
 class statement_backend;
+class statement_impl;
+class statistics_collector;
 class rowid_backend;
 class blob_backend;
 
 } // namespace details
 
 class connection_pool;
+class routing_pool;
+enum class access_intent;
 class failover_callback;
 
 class SOCI_DECL session
@@ -60,6 +69,7 @@ public:
     session(std::string const & backendName, std::string const & connectString);
     explicit session(std::string const & connectString);
     explicit session(connection_pool & pool);
+    session(routing_pool & pool, access_intent intent);
 
     session(session &&other);
     session &operator=(session &&other);
@@ -120,11 +130,59 @@ public:
     std::string get_last_query() const;
     std::string get_last_query_context() const;
 
+    // These functions are used by the statements to avoid formatting their
+    // parameters on each execution: instead, the statement only copies their
+    // values, which are given to the session before the statement parameters
+    // become unavailable, and they're only formatted and passed to
+    // add_query_parameter() when the query context is really needed.
+    //
+    // This is only done with the standard logger, which only uses the
+    // parameters of the last query, so defer_query_parameters() returns false
+    // if a custom logger is used and the parameters must be added immediately.
+    bool defer_query_parameters(details::statement_impl * st);
+    void add_deferred_query_parameters(details::statement_impl * st);
+
     void set_got_data(bool gotData);
     bool got_data() const;
 
     void uppercase_column_names(bool forceToUpper);
 
+    // If enabled, the columns of the rows used with dynamic queries are only
+    // converted to their C++ type when they are accessed, instead of
+    // converting all of them after fetching each row. This is only done if
+    // the backend supports it and is transparent for the rows, except that
+    // conversion errors are reported when accessing the column value.
+    void lazy_row_conversion(bool lazy);
+    bool get_lazy_row_conversion() const;
+
+    // Enable or disable collecting the statistics about the statements using
+    // this session, which is disabled by default as it requires measuring
+    // the time taken by them. Disabling it doesn't reset the statistics
+    // already collected, use reset_statistics() to do it.
+    void collect_statistics(bool collect);
+    bool get_collect_statistics() const;
+
+    // Return the statistics collected so far, including at most the given
+    // number of the queries with the biggest total time.
+    session_statistics get_statistics(std::size_t topQueries = 10) const;
+    void reset_statistics();
+
+    // Used by the statements to update the statistics: returns null if they
+    // are not being collected.
+    details::statistics_collector * get_statistics_collector();
+
+    // Statements prepared in advance, e.g. by connection_pool after opening
+    // the session, can be retrieved using their keys and executed without
+    // preparing them again. They are discarded when the session is closed.
+    void add_prepared_statement(std::string const & key, std::string const & query);
+    bool has_prepared_statement(std::string const & key) const;
+    statement & get_prepared_statement(std::string const & key);
+
+    // Remove the bindings of all prepared statements: this is done by
+    // connection_pool when the session is given back to it, so that they
+    // don't refer to the variables of its previous user. Never throws.
+    void unbind_prepared_statements();
+
     bool get_uppercase_column_names() const;
 
     // Functions for dealing with sequence/auto-increment values.
@@ -261,15 +319,36 @@ private:
     void reset_after_move();
     schema_table_name& alloc_schema_table_name(const std::string& tableName);
 
+    // Take the deferred parameters from the statement, if any, and add them
+    // to the logger.
+    void format_deferred_query_parameters();
+
     std::ostringstream query_stream_;
     std::unique_ptr<details::query_transformation_function> query_transformation_;
 
     log_context query_ctx_logging_mode_ = log_context::always;
     logger logger_;
 
+    // The statement whose parameters must be added to the logger when needed.
+    details::statement_impl * deferredParamsStatement_ = nullptr;
+
+    // The parameters taken from the statement above, not formatted yet.
+    std::vector<std::string> deferredParamsNames_;
+    std::vector<details::use_value_snapshot> deferredParamsValues_;
+
+    // True if a custom logger was set using set_logger().
+    bool hasCustomLogger_ = false;
+
     connection_parameters lastConnectParameters_;
 
     bool uppercaseColumnNames_ = false;
+    bool lazyRowConversion_ = false;
+
+    // Always allocated by the constructors, except for the sessions leased
+    // from a pool, so that the pointer never changes after the session is
+    // shared with the other threads.
+    std::unique_ptr<details::statistics_collector> statistics_;
+    bool collectStatistics_ = false;
 
     details::session_backend * backEnd_ = nullptr;
 
@@ -284,6 +363,9 @@ private:
     // span. The prepare_temp_type uses the addresses of the content of the
     // schema_table_name_ thus, a container which doesn't move data is used.
     std::forward_list<schema_table_name> schema_table_name_;
+
+    // Must be cleared before destroying the backend used by the statements.
+    std::map<std::string, std::unique_ptr<statement>> preparedStatements_;
 };
 
 } // namespace soci
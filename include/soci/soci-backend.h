@@ -253,6 +253,10 @@ public:
     // triggered an error during execute(), it should return its index.
     virtual int get_row_to_dump() const { return -1; }
 
+    // Return the number of round trips to the server performed by the last
+    // call to execute() or fetch(), or -1 if this is unknown (the default).
+    virtual int get_round_trips() const { return -1; }
+
     virtual std::string rewrite_for_procedure_call(std::string const& query) = 0;
 
     virtual int prepare_for_describe() = 0;
@@ -302,6 +306,13 @@ public:
     // notably this is the case for dynamic (i.e. row-based) binding.
     virtual db_type exchange_dbtype_for(db_type type) const { return type; }
 
+    // Return true if the post_fetch() function of the single row into
+    // elements can be called at any moment after fetching the row and until
+    // the next fetch, in any order, and not necessarily for all of them. This
+    // allows to only convert the columns actually used when the lazy row
+    // conversion is enabled.
+    virtual bool supports_lazy_row_conversion() const { return false; }
+
     // These are set when the corresponding make_xxx_backend() above is called
     // by statement_impl. This goes against encapsulation but allows to avoid
     // having to set them in all backends implementations of these functions.
@@ -560,6 +571,18 @@ public:
         session_ = &sql;
     }
 
+    // This function is called by connection_pool when a session using this
+    // backend is given back to it. It does nothing by default, but backends
+    // using their own native pool may release the physical connection here
+    // and acquire it again on the next use of the session. As it may be called
+    // from session destructor, this function must not throw.
+    virtual void on_pool_give_back() {}
+
+    // Return false if the statements can't be kept prepared in this session
+    // while it is in connection_pool, e.g. because they would be used with a
+    // different physical connection after on_pool_give_back().
+    virtual bool supports_pool_prepared_statements() const { return true; }
+
     virtual database_engine get_database_engine() const = 0;
 
     virtual std::string get_backend_name() const = 0;
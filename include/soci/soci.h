@@ -13,6 +13,8 @@
 #include "soci/backend-loader.h"
 #include "soci/blob.h"
 #include "soci/blob-exchange.h"
+#include "soci/column-batch.h"
+#include "soci/column-batch-exchange.h"
 #include "soci/column-info.h"
 #include "soci/connection-pool.h"
 #include "soci/error.h"
@@ -23,14 +25,17 @@
 #include "soci/once-temp-type.h"
 #include "soci/prepare-temp-type.h"
 #include "soci/procedure.h"
+#include "soci/query-fingerprint.h"
 #include "soci/ref-counted-prepare-info.h"
 #include "soci/ref-counted-statement.h"
+#include "soci/routing-pool.h"
 #include "soci/row.h"
 #include "soci/row-exchange.h"
 #include "soci/rowid.h"
 #include "soci/rowid-exchange.h"
 #include "soci/rowset.h"
 #include "soci/session.h"
+#include "soci/session-statistics.h"
 #include "soci/soci-backend.h"
 #include "soci/statement.h"
 #include "soci/transaction.h"
@@ -39,6 +44,7 @@
 #include "soci/type-holder.h"
 #include "soci/type-ptr.h"
 #include "soci/type-wrappers.h"
+#include "soci/typed-statement.h"
 #include "soci/use.h"
 #include "soci/use-type.h"
 #include "soci/values.h"
@@ -257,6 +257,8 @@ struct SOCI_SQLITE3_DECL sqlite3_statement_backend : details::statement_backend
 
     db_type exchange_dbtype_for(db_type type) const override;
 
+    bool supports_lazy_row_conversion() const override { return true; }
+
     sqlite3_session_backend &session_;
     sqlite_api::sqlite3_stmt *stmt_;
     sqlite3_recordset dataCache_;
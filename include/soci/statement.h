@@ -11,12 +11,15 @@
 #include "soci/bind-values.h"
 #include "soci/into-type.h"
 #include "soci/into.h"
+#include "soci/logger.h"
 #include "soci/use-type.h"
 #include "soci/use.h"
 #include "soci/soci-backend.h"
 #include "soci/row.h"
+#include "soci/column-batch.h"
 #include "soci/blob.h"
 // std
+#include <chrono>
 #include <cstddef>
 #include <string>
 #include <vector>
@@ -33,6 +36,7 @@ namespace details
 class into_type_base;
 class use_type_base;
 class prepare_temp_type;
+class statistics_collector;
 
 class SOCI_DECL statement_impl
 {
@@ -67,11 +71,39 @@ public:
     bool fetch();
     void describe();
     void set_row(row * r);
+    void set_column_batch(column_batch * b);
+
+    // Return true if the query contains the named placeholder with the given
+    // name, i.e. ":name" not followed by any other alphanumeric characters.
+    bool has_named_placeholder(std::string const & name) const;
+
+    // Check that the query returns the columns of the given types when it is
+    // executed for the first time, empty vector disables the check.
+    void set_expected_columns(std::vector<exchange_type> const & types);
+
+    // Return the fingerprint of the query, computing it on first use.
+    query_fingerprint const & get_query_fingerprint();
+
+    // Used by the row when the lazy row conversion is enabled.
+    void load_row_column(std::size_t pos);
+    void detach_lazy_row() { lazyRow_ = false; }
+
+    // Used by the session to take the names and the values of the parameters
+    // of the last execution, which are formatted only if and when the query
+    // context is needed.
+    void release_query_parameters(std::vector<std::string> & names,
+                                  std::vector<use_value_snapshot> & values);
+
     void exchange_for_rowset(into_type_ptr const & i) { exchange_for_rowset_(i); }
     template<typename T, typename Indicator>
     void exchange_for_rowset(into_container<T, Indicator> const &ic)
     { exchange_for_rowset_(ic); }
 
+    // Used by rowset with prefetch option to bind a vector for each column.
+    template<typename... Intos>
+    void exchange_for_rowset(Intos const &... i)
+    { exchange_for_rowset_(i...); }
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     statement_backend * get_backend() { return backEnd_; }
@@ -101,9 +133,45 @@ private:
     [[noreturn]]
     void rethrow_current_exception_with_context(char const* operation);
 
+    // Implementations of execute() and fetch() which are wrapped by them to
+    // notify the logger about their outcome, if it's interested in it.
+    bool do_execute(bool withDataExchange);
+    bool do_fetch();
+
+    // Fill in the query_end_info after executing the statement or fetching
+    // data from it and pass it to the logger and the statistics collector,
+    // if they need it.
+    void end_query(bool isExecute,
+                   logger const & log,
+                   statistics_collector * stats,
+                   query_end_info & info,
+                   std::chrono::steady_clock::time_point start,
+                   std::chrono::steady_clock::duration backendTime,
+                   bool gotData);
+
+    // If non-null, the time spent in the backend calls is added to it.
+    std::chrono::steady_clock::duration * backendTime_ = nullptr;
+
+    // Only valid if fingerprintComputed_ is true.
+    query_fingerprint fingerprint_;
+    bool fingerprintComputed_ = false;
+
     int refCount_;
 
     row * row_;
+    column_batch * batch_ = nullptr;
+
+    // Index of the first element of intos_ added for the batch columns.
+    std::size_t firstBatchInto_ = 0;
+
+    // Types of the columns the query must return, if not empty, and whether
+    // they were already checked.
+    std::vector<exchange_type> expectedColumns_;
+    bool columnsChecked_ = false;
+    void check_columns(bool afterExecute);
+
+    // True if the values of row_ columns are only retrieved on demand.
+    bool lazyRow_ = false;
     std::size_t fetchSize_;
     std::size_t initialFetchSize_;
     std::string query_;
@@ -111,15 +179,16 @@ private:
     into_type_vector intosForRow_;
     int definePositionForRow_ = 1;
 
-    template <typename Into>
-    void exchange_for_rowset_(Into const &i)
+    template <typename... Intos>
+    void exchange_for_rowset_(Intos const &... i)
     {
         if (intos_.empty() == false)
         {
             throw soci_error("Explicit into elements not allowed with rowset.");
         }
 
-        intos_.exchange(i);
+        int dummy[] = { 0, (intos_.exchange(i), 0)... };
+        (void)dummy;
 
         int definePosition = 1;
         for(auto & into : intos_)
@@ -136,19 +205,39 @@ private:
     template<typename T>
     void into_row()
     {
-        T * t = new T();
-        indicator * ind = new indicator(i_ok);
+        if (batch_ != nullptr)
+        {
+            into_batch<T>();
+            return;
+        }
+
+        T * t;
+        indicator * ind;
         row_->add_holder(t, ind);
         exchange_for_row(into(*t, *ind));
     }
 
+    // Unlike the elements injected for the row, the vectors used for the
+    // column batch are resized together with the explicit elements.
+    template<typename T>
+    void into_batch()
+    {
+        column_batch_column<T> & column = batch_->add_column<T>();
+        intos_.exchange(into(column.values_, column.indicators_));
+    }
+
     template<db_type>
     void bind_into();
 
     bool alreadyDescribed_;
 
-    // Unconditionally call session::add_query_parameter() for all parameters.
-    void do_add_query_parameters();
+    // Unconditionally call session::add_query_parameter() for all parameters,
+    // using the given row for the bulk ones.
+    void do_add_query_parameters(int rowToDump) const;
+
+    // Values of the parameters at the time of the last execution, used when
+    // they're added to the query context after it.
+    std::vector<use_value_snapshot> paramsSnapshot_;
 
     std::size_t intos_size();
     std::size_t uses_size();
@@ -237,6 +326,15 @@ public:
 
     void describe()       { impl_->describe(); }
     void set_row(row * r) { impl_->set_row(r); }
+    void set_expected_columns(std::vector<details::exchange_type> const & types)
+    {
+        impl_->set_expected_columns(types);
+    }
+
+    query_fingerprint const & get_query_fingerprint()
+    {
+        return impl_->get_query_fingerprint();
+    }
 
     template <typename T, typename Indicator>
     void exchange_for_rowset(details::into_container<T, Indicator> const & ic)
@@ -249,6 +347,12 @@ public:
         impl_->exchange_for_rowset(i);
     }
 
+    template <typename... Intos>
+    void exchange_for_rowset(Intos const &... i)
+    {
+        impl_->exchange_for_rowset(i...);
+    }
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     details::statement_backend * get_backend()
@@ -306,65 +306,69 @@ struct type_holder_trait<blob>
 struct value_cast_tag{};
 struct value_reference_tag{};
 
-// Class for storing type data instances in a container of holder objects
+// Class for storing pointers to type data instances of different types in a
+// container of holder objects. The objects themselves are not owned by the
+// holder, which only allows to destroy them in place, and are usually stored
+// in a single buffer allocated by the container owner.
 class holder
 {
 public:
     template <typename T>
-    static holder* make_holder(T* val)
+    static holder make_holder(T* val)
     {
-         return new holder(type_holder_trait<T>::type, val);
+         return holder(type_holder_trait<T>::type, val);
     }
 
-    ~holder()
+    // Call the destructor of the object without freeing its memory.
+    void destroy()
     {
         switch (dt_)
         {
         case db_double:
-            delete val_.d;
+            destroy_value(val_.d);
             break;
         case db_int8:
-            delete val_.i8;
+            destroy_value(val_.i8);
             break;
         case db_int16:
-            delete val_.i16;
+            destroy_value(val_.i16);
             break;
         case db_int32:
-            delete val_.i32;
+            destroy_value(val_.i32);
             break;
         case db_int64:
-            delete val_.i64;
+            destroy_value(val_.i64);
             break;
         case db_uint8:
-            delete val_.u8;
+            destroy_value(val_.u8);
             break;
         case db_uint16:
-            delete val_.u16;
+            destroy_value(val_.u16);
             break;
         case db_uint32:
-            delete val_.u32;
+            destroy_value(val_.u32);
             break;
         case db_uint64:
-            delete val_.u64;
+            destroy_value(val_.u64);
             break;
         case db_date:
-            delete val_.t;
+            destroy_value(val_.t);
             break;
         case db_blob:
-            delete val_.b;
+            destroy_value(val_.b);
             break;
         case db_xml:
         case db_string:
-            delete val_.s;
+            destroy_value(val_.s);
             break;
         case db_wstring:
-            delete val_.ws;
+            destroy_value(val_.ws);
             break;
         }
     }
 
     template <typename T>
-    T get(value_cast_tag)
+    T get(value_cast_tag) const
     {
         switch (dt_)
         {
@@ -401,7 +405,7 @@ public:
     }
 
     template <typename T>
-    T& get(value_reference_tag)
+    T& get(value_reference_tag) const
     {
         switch (dt_)
         {
@@ -438,6 +442,12 @@ public:
     }
 
 private:
+    template <typename T>
+    static void destroy_value(T* val)
+    {
+        val->~T();
+    }
+
     holder(db_type dt, void* val) : dt_(dt)
     {
         switch (dt_)
@@ -488,7 +498,7 @@ private:
         throw soci_error("Created holder with unsupported type {}", static_cast<int>(dt));
     }
 
-    const db_type dt_;
+    db_type dt_;
     type_holder val_;
 };
 
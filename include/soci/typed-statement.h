@@ -0,0 +1,180 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_TYPED_STATEMENT_H_INCLUDED
+#define SOCI_TYPED_STATEMENT_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/into.h"
+#include "soci/rowset.h"
+#include "soci/session.h"
+#include "soci/statement.h"
+#include "soci/use.h"
+// std
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace soci
+{
+
+template <typename Columns, typename Params = std::tuple<> >
+class typed_statement;
+
+// Statement for which the types of the result columns and of the parameters
+// are known at compile time.
+//
+// A vector is bound for each column, so that the rows are fetched in batches
+// of the size given by the prefetch option and then returned one by one from
+// these vectors, without going through the statement and the backend for each
+// of them. The number and the types of the columns returned by the query are
+// checked when it is executed for the first time.
+//
+// Columns which can be NULL must use std::optional<> (or another type with
+// the corresponding conversion) as any other vectors would.
+template <typename... Cols, typename... Params>
+class typed_statement<std::tuple<Cols...>, std::tuple<Params...> >
+{
+public:
+    typedef std::tuple<Cols...> row_type;
+    typedef std::tuple<Params...> params_type;
+
+    typed_statement(session & sql, std::string const & query,
+                    prefetch const & p = prefetch(100))
+        : st_(sql), fetchSize_(p.get_rows()), rows_(0), pos_(0), more_(false)
+    {
+        if (fetchSize_ == 0)
+        {
+            throw soci_error("Vectors of size 0 are not allowed.");
+        }
+
+        resize_columns(index_sequence());
+        exchange_columns(index_sequence());
+        exchange_params(std::index_sequence_for<Params...>());
+
+        st_.alloc();
+        st_.prepare(query);
+        st_.define_and_bind();
+        st_.set_expected_columns({ static_cast<details::exchange_type>(
+            details::exchange_traits<Cols>::x_type)... });
+    }
+
+    // Execute the statement with the given parameters. If it returns any
+    // columns, its rows must then be retrieved using fetch().
+    void execute(Params const &... params)
+    {
+        params_ = params_type(params...);
+
+        rows_ = 0;
+        pos_ = 0;
+
+        if (sizeof...(Cols) == 0)
+        {
+            st_.execute(true);
+            more_ = false;
+        }
+        else
+        {
+            resize_columns(index_sequence());
+            st_.execute(false);
+            more_ = true;
+        }
+    }
+
+    // Retrieve the next row, return false if there are no more rows.
+    bool fetch(row_type & r)
+    {
+        static_assert(sizeof...(Cols) != 0,
+                      "fetch() can't be used with statements without columns");
+
+        if (pos_ == rows_)
+        {
+            if (!more_)
+            {
+                return false;
+            }
+
+            resize_columns(index_sequence());
+            more_ = st_.fetch();
+            rows_ = more_ ? first_column_size() : 0;
+            pos_ = 0;
+
+            if (rows_ == 0)
+            {
+                more_ = false;
+                return false;
+            }
+        }
+
+        get_row(r, index_sequence());
+        ++pos_;
+
+        return true;
+    }
+
+    long long get_affected_rows() { return st_.get_affected_rows(); }
+
+private:
+    typedef std::index_sequence_for<Cols...> index_sequence;
+
+    template <std::size_t... I>
+    void resize_columns(std::index_sequence<I...>)
+    {
+        int dummy[] = { 0, (std::get<I>(columns_).resize(fetchSize_), 0)... };
+        (void)dummy;
+    }
+
+    template <std::size_t... I>
+    void exchange_columns(std::index_sequence<I...>)
+    {
+        int dummy[] = { 0, (st_.exchange(into(std::get<I>(columns_))), 0)... };
+        (void)dummy;
+    }
+
+    template <std::size_t... I>
+    void exchange_params(std::index_sequence<I...>)
+    {
+        int dummy[] = { 0, (st_.exchange(use(std::get<I>(params_))), 0)... };
+        (void)dummy;
+    }
+
+    template <std::size_t... I>
+    void get_row(row_type & r, std::index_sequence<I...>)
+    {
+        int dummy[] = { 0,
+            (std::get<I>(r) = std::move(std::get<I>(columns_)[pos_]), 0)... };
+        (void)dummy;
+    }
+
+    std::size_t first_column_size() const
+    {
+        return std::get<0>(columns_).size();
+    }
+
+    // These vectors and parameters are bound to the statement, so they must
+    // be destroyed after it.
+    std::tuple<std::vector<Cols>...> columns_;
+    params_type params_;
+
+    statement st_;
+
+    std::size_t const fetchSize_;
+
+    // Number of rows in the vectors and the position of the next one.
+    std::size_t rows_;
+    std::size_t pos_;
+
+    // False once the statement doesn't have any more rows.
+    bool more_;
+
+    SOCI_NOT_COPYABLE(typed_statement)
+};
+
+} // namespace soci
+
+#endif // SOCI_TYPED_STATEMENT_H_INCLUDED
@@ -14,6 +14,8 @@
 #include "soci/exchange-traits.h"
 // std
 #include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -22,6 +24,38 @@ namespace soci { namespace details {
 
 class statement_impl;
 
+// Copy of the value of a use element made when executing the statement, which
+// allows to format it later, and only if it's needed, for the query context.
+struct SOCI_DECL use_value_snapshot
+{
+    // Output the value in the same format as use_type_base::dump_value().
+    void dump(std::ostream& os) const;
+
+    exchange_type type = x_stdstring;
+    bool isNull = false;
+
+    // If true, the value was already formatted and is stored in str.
+    bool formatted = false;
+
+    // Only the member corresponding to the type is used.
+    union
+    {
+        char c;
+        int8_t i8;
+        uint8_t u8;
+        int16_t i16;
+        uint16_t u16;
+        int32_t i32;
+        uint32_t u32;
+        int64_t i64;
+        uint64_t u64;
+        double d;
+    } scalar;
+    std::tm tm;
+    std::string str;
+    std::wstring wstr;
+};
+
 // this is intended to be a base class for all classes that deal with
 // binding input data (and OUT PL/SQL variables)
 class SOCI_DECL use_type_base
@@ -32,6 +66,11 @@ public:
     virtual void bind(statement_impl & st, int & position) = 0;
     virtual std::string get_name() const = 0;
     virtual void dump_value(std::ostream& os, int index) const = 0;
+
+    // Copy the value, as dump_value() would output it, to the snapshot. The
+    // default implementation simply formats it immediately.
+    virtual void snapshot_value(use_value_snapshot& s, int index) const;
+
     virtual void pre_exec(int num) = 0;
     virtual void pre_use() = 0;
     virtual void post_use(bool gotData) = 0;
@@ -77,7 +116,9 @@ public:
     void bind(statement_impl & st, int & position) override;
     std::string get_name() const override { return name_; }
     void dump_value(std::ostream& os, int index) const override;
+    void snapshot_value(use_value_snapshot& s, int index) const override;
     virtual void * get_data() { return data_; }
+    exchange_type get_type() const { return type_; }
 
     // conversion hook (from arbitrary user type to base type)
     virtual void convert_to_base() {}
@@ -158,6 +199,7 @@ private:
     void bind(statement_impl& st, int & position) override;
     std::string get_name() const override { return name_; }
     void dump_value(std::ostream& os, int index) const override;
+    void snapshot_value(use_value_snapshot& s, int index) const override;
     void pre_exec(int num) override;
     void pre_use() override;
     void post_use(bool) override { /* nothing to do */ }
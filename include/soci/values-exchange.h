@@ -14,6 +14,7 @@
 #include "soci/row-exchange.h"
 // std
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -103,12 +104,54 @@ private:
     SOCI_NOT_COPYABLE(use_type)
 };
 
-// this is not supposed to be used - no support for bulk ORM
+class values_use_column;
+
+// Bulk operations with the types mapped using values: the columns are found
+// from the values filled by the type conversion for the first element and a
+// vector use element is bound for each of them, so that all elements are
+// sent to the database at once. Before each execution, the values of all
+// elements are copied into these vectors.
 template <>
-class use_type<std::vector<values> >
+class SOCI_DECL use_type<std::vector<values> > : public use_type_base
 {
+public:
+    use_type(std::vector<values> & v, std::string const & name = std::string());
+    use_type(std::vector<values> & v, std::size_t begin, std::size_t * end,
+        std::string const & name = std::string());
+    use_type(std::vector<values> & v, std::vector<indicator> const & ind,
+        std::string const & name = std::string());
+    use_type(std::vector<values> & v, std::vector<indicator> const & ind,
+        std::size_t begin, std::size_t * end,
+        std::string const & name = std::string());
+    ~use_type() override;
+
+    void bind(details::statement_impl & st, int & position) override;
+    std::string get_name() const override;
+    void dump_value(std::ostream& os, int index) const override;
+    void pre_exec(int num) override;
+    void pre_use() override;
+    void post_use(bool gotData) override;
+    void clean_up() override;
+    std::size_t size() const override { return rows_; }
+
+    // this is used only to re-dispatch to derived class
+    // (the derived class might be generated automatically by
+    // user conversions)
+    virtual void convert_to_base() {}
+
 private:
-    use_type();
+    void clean_up_values();
+
+    std::vector<values> & v_;
+    std::size_t * end_;
+
+    // Number of use elements set by the type conversion for each element.
+    std::size_t numUses_;
+
+    std::vector<std::unique_ptr<values_use_column> > columns_;
+    std::size_t rows_;
+
+    SOCI_NOT_COPYABLE(use_type)
 };
 
 template <>
@@ -134,12 +177,41 @@ private:
     SOCI_NOT_COPYABLE(into_type)
 };
 
-// this is not supposed to be used - no support for bulk ORM
+// Bulk fetching of the types mapped using values: the result columns are
+// fetched into a column_batch and each element refers to one of its rows when
+// the type conversion is called for it.
 template <>
-class into_type<std::vector<values> >
+class SOCI_DECL into_type<std::vector<values> > : public into_type_base
 {
+public:
+    into_type(std::vector<values> & v);
+    into_type(std::vector<values> & v, std::size_t begin, std::size_t * end);
+    into_type(std::vector<values> & v, std::vector<indicator> & ind);
+    into_type(std::vector<values> & v, std::vector<indicator> & ind,
+        std::size_t begin, std::size_t * end);
+    ~into_type() override;
+
+    void define(statement_impl & st, int & position) override;
+    void pre_exec(int /* num */) override {}
+    void pre_fetch() override {}
+    void post_fetch(bool gotData, bool calledFromFetch) override;
+    void clean_up() override;
+    std::size_t size() const override;
+    void resize(std::size_t sz) override;
+
+    // this is used only to re-dispatch to derived class
+    // (the derived class might be generated automatically by
+    // user conversions)
+    virtual void convert_from_base() {}
+
 private:
-    into_type();
+    std::vector<values> & v_;
+    std::vector<indicator> * ind_;
+    std::size_t * end_;
+
+    std::unique_ptr<column_batch> batch_;
+
+    SOCI_NOT_COPYABLE(into_type)
 };
 
 } // namespace details
@@ -9,6 +9,7 @@
 #define SOCI_VALUES_H_INCLUDED
 
 #include "soci/statement.h"
+#include "soci/column-batch.h"
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 // std
@@ -45,13 +46,22 @@ class SOCI_DECL values
     friend class details::statement_impl;
     friend class details::into_type<values>;
     friend class details::use_type<values>;
+    friend class details::into_type<std::vector<values> >;
+    friend class details::use_type<std::vector<values> >;
 
 public:
 
-    values() : row_(nullptr), currentPos_(0), uppercaseColumnNames_(false) {}
+    values()
+        : row_(nullptr), batch_(nullptr), batchRow_(0), currentPos_(0),
+          uppercaseColumnNames_(false)
+    {}
 
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const & name) const;
+    indicator get_indicator(column_ref const & col) const;
+
+    // Throws if there is no column with the given name.
+    column_ref get_column_ref(std::string const & name) const;
 
     template <typename T>
     T get(std::size_t pos) const
@@ -60,6 +70,10 @@ public:
         {
             return row_->get<T>(pos);
         }
+        else if (batch_ != nullptr)
+        {
+            return get_from_batch<T>(pos);
+        }
         else if (*indicators_[pos] != i_null)
         {
             return get_from_uses<T>(pos);
@@ -77,6 +91,12 @@ public:
         {
             return row_->get<T>(pos, nullValue);
         }
+        else if (batch_ != nullptr)
+        {
+            return batch_->get_indicators(pos).at(batchRow_) == i_null
+                ? nullValue
+                : get_from_batch<T>(pos);
+        }
         else if (*indicators_[pos] == i_null)
         {
             return nullValue;
@@ -90,15 +110,49 @@ public:
     template <typename T>
     T get(std::string const & name) const
     {
-        return row_ != nullptr ? row_->get<T>(name) : get_from_uses<T>(name);
+        if (row_ != nullptr)
+        {
+            return row_->get<T>(name);
+        }
+        else if (batch_ != nullptr)
+        {
+            return get_from_batch<T>(batch_->find_column(name));
+        }
+        else
+        {
+            return get_from_uses<T>(name);
+        }
     }
 
     template <typename T>
     T get(std::string const & name, T const & nullValue) const
+    {
+        if (row_ != nullptr)
+        {
+            return row_->get<T>(name, nullValue);
+        }
+        else if (batch_ != nullptr)
+        {
+            return get<T>(batch_->find_column(name), nullValue);
+        }
+        else
+        {
+            return get_from_uses<T>(name, nullValue);
+        }
+    }
+
+    template <typename T>
+    T get(column_ref const & col) const
+    {
+        return row_ != nullptr ? row_->get<T>(col) : get<T>(col.pos_);
+    }
+
+    template <typename T>
+    T get(column_ref const & col, T const & nullValue) const
     {
         return row_ != nullptr
-            ? row_->get<T>(name, nullValue)
-            : get_from_uses<T>(name, nullValue);
+            ? row_->get<T>(col, nullValue)
+            : get<T>(col.pos_, nullValue);
     }
 
     template <typename T>
@@ -111,6 +165,11 @@ public:
 
             *row_ >> value;
         }
+        else if (batch_ != nullptr)
+        {
+            value = get_from_batch<T>(currentPos_);
+            ++currentPos_;
+        }
         else if (*indicators_[currentPos_] != i_null)
         {
             // if there is no row object, then the data can be
@@ -239,7 +298,12 @@ public:
 
     std::size_t get_number_of_columns() const
     {
-        return row_ ? row_->size() : 0;
+        if (row_)
+        {
+            return row_->size();
+        }
+
+        return batch_ ? batch_->get_number_of_columns() : 0;
     }
 
     column_properties const& get_properties(std::size_t pos) const;
@@ -256,6 +320,11 @@ private:
     std::map<std::string, std::size_t> index_;
     std::vector<details::copy_base *> deepCopies_;
 
+    // When fetching into a vector of values, each of them refers to a row of
+    // the column batch used for the statement instead of having its own row.
+    column_batch * batch_;
+    std::size_t batchRow_;
+
     mutable std::size_t currentPos_;
 
     bool uppercaseColumnNames_;
@@ -312,6 +381,28 @@ private:
         }
     }
 
+    template <typename T>
+    T get_from_batch(std::size_t pos) const
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+
+        details::holder const h = batch_->get_holder(batchRow_, pos);
+        base_type const& baseVal = h.get<base_type>(details::value_cast_tag{});
+
+        T val;
+        indicator ind = batch_->get_indicators(pos)[batchRow_];
+        type_conversion<T>::from_base(baseVal, ind, val);
+        return val;
+    }
+
+    // this is called by into_type<std::vector<values> > for each element
+    void set_batch_row(column_batch * batch, std::size_t row)
+    {
+        batch_ = batch;
+        batchRow_ = row;
+        currentPos_ = 0;
+    }
+
     row& get_row()
     {
         row_ = new row();
@@ -348,6 +439,32 @@ private:
             delete deepCopie;
         }
     }
+
+    // this is called by use_type<std::vector<values> >, which doesn't bind
+    // the use elements created by set() but only copies their values, so
+    // they must all be deleted here
+    void clean_up_uses()
+    {
+        for (auto & u : uses_)
+        {
+            delete u;
+        }
+
+        for (auto & i : indicators_)
+        {
+            delete i;
+        }
+
+        for (auto & deepCopie : deepCopies_)
+        {
+            delete deepCopie;
+        }
+
+        uses_.clear();
+        indicators_.clear();
+        index_.clear();
+        deepCopies_.clear();
+    }
 };
 
 } // namespace soci
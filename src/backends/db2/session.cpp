@@ -18,6 +18,7 @@ using namespace soci;
 using namespace soci::details;
 
 const char* soci::db2_option_driver_complete = "db2.driver_complete";
+const char* soci::db2_option_continue_on_error = "db2.continue_on_error";
 
 const std::string db2_soci_error::sqlState(std::string const & msg,const SQLSMALLINT htype,const SQLHANDLE hndl) {
     SQLCHAR message[SQL_MAX_MESSAGE_LENGTH + 1];
@@ -69,11 +70,18 @@ void db2_session_backend::parseConnectString(std::string const &  connectString)
 
 db2_session_backend::db2_session_backend(
     connection_parameters const & parameters) :
-        in_transaction(false)
+        in_transaction(false), continueOnError_(false)
 {
     std::string const& connectString = parameters.get_connect_string();
     parseConnectString(connectString);
 
+    std::string continueOnErrorString;
+    if (parameters.get_option(db2_option_continue_on_error, continueOnErrorString))
+    {
+        continueOnError_ = connection_parameters::is_true_value(
+            db2_option_continue_on_error, continueOnErrorString);
+    }
+
     SQLRETURN cliRC = SQL_ERROR;
 
     /* Prepare handles */
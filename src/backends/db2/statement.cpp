@@ -7,13 +7,15 @@
 //
 
 #include "soci/db2/soci-db2.h"
+#include <algorithm>
 #include <cctype>
 
 using namespace soci;
 using namespace soci::details;
 
 db2_statement_backend::db2_statement_backend(db2_session_backend &session)
-    : session_(session),hasVectorUseElements(false),use_binding_method_(details::db2::BOUND_BY_NONE)
+    : session_(session),hasVectorUseElements(false),use_binding_method_(details::db2::BOUND_BY_NONE),
+      continueOnError_(session.continueOnError_)
 {
 }
 
@@ -25,6 +27,8 @@ void db2_statement_backend::alloc()
     if (cliRC != SQL_SUCCESS) {
         throw db2_soci_error("Error while allocation statement handle",cliRC);
     }
+
+    nonAtomic_ = false;
 }
 
 void db2_statement_backend::clean_up()
@@ -119,15 +123,38 @@ void db2_statement_backend::prepare(std::string const &  query ,
     }
 }
 
+void db2_statement_backend::prepare_bulk_status(std::size_t rows)
+{
+    paramsProcessed_ = 0;
+    paramStatus_.assign(rows, SQL_PARAM_UNUSED);
+
+    SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &paramsProcessed_, 0);
+    SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_STATUS_PTR, paramStatus_.data(), 0);
+}
+
 statement_backend::exec_fetch_result
 db2_statement_backend::execute(int  number )
 {
-    SQLUINTEGER rows_processed = 0;
     SQLRETURN cliRC;
 
-    if (hasVectorUseElements)
+    bulkResults_.clear();
+    error_row_ = -1;
+    rowsAffected_ = -1;
+
+    bool const nonAtomic = hasVectorUseElements && continueOnError_;
+    if (nonAtomic != nonAtomic_)
     {
-        SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &rows_processed, 0);
+        // By default, the entire array is processed atomically and a single
+        // failing row makes all the others fail too. Restore this default if
+        // the option was turned off after we changed it.
+        cliRC = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMOPT_ATOMIC,
+                               (SQLPOINTER)(nonAtomic ? SQL_ATOMIC_NO : SQL_ATOMIC_YES), 0);
+        if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO)
+        {
+            throw db2_soci_error(db2_soci_error::sqlState("Error while changing atomic array processing",SQL_HANDLE_STMT,hStmt),cliRC);
+        }
+
+        nonAtomic_ = nonAtomic;
     }
 
     // if we are called twice for the same statement we need to close the open
@@ -139,9 +166,35 @@ db2_statement_backend::execute(int  number )
     }
 
     cliRC = SQLExecute(hStmt);
-    if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO && cliRC != SQL_NO_DATA)
+
+    std::size_t bulkSuccesses = 0;
+    if (hasVectorUseElements)
     {
-        throw db2_soci_error(db2_soci_error::sqlState("Statement execution error",SQL_HANDLE_STMT,hStmt),cliRC);
+        bulkSuccesses = update_bulk_results();
+    }
+
+    // SQL_SUCCESS_WITH_INFO indicates an error too if some rows of a bulk
+    // operation failed.
+    if ((cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO && cliRC != SQL_NO_DATA)
+            || error_row_ != -1)
+    {
+        std::string const msg = db2_soci_error::sqlState("Statement execution error",SQL_HANDLE_STMT,hStmt);
+
+        if (hasVectorUseElements)
+        {
+            rowsAffected_ = static_cast<long long>(bulkSuccesses);
+
+            collect_bulk_diagnostics();
+
+            // Don't throw, if asked not to, as long as the errors can be
+            // attributed to the individual rows.
+            if (continueOnError_ && error_row_ != -1)
+            {
+                return ef_success;
+            }
+        }
+
+        throw db2_soci_error(msg,cliRC);
     }
 
     SQLSMALLINT colCount;
@@ -179,8 +232,91 @@ db2_statement_backend::fetch(int  number )
     return ef_success;
 }
 
+std::size_t db2_statement_backend::update_bulk_results()
+{
+    std::size_t successes = 0;
+
+    bulkResults_.resize(paramsProcessed_);
+    for (SQLULEN i = 0; i < paramsProcessed_ && i < paramStatus_.size(); ++i)
+    {
+        bulkResults_[i].status = paramStatus_[i];
+
+        switch (paramStatus_[i])
+        {
+            case SQL_PARAM_SUCCESS:
+            case SQL_PARAM_SUCCESS_WITH_INFO:
+                ++successes;
+                break;
+
+            case SQL_PARAM_ERROR:
+                if (error_row_ == -1)
+                    error_row_ = static_cast<int>(i);
+                break;
+
+            default:
+                // SQL_PARAM_UNUSED or SQL_PARAM_DIAG_UNAVAILABLE, which we
+                // shouldn't get, normally, but just ignore them if we do.
+                break;
+        }
+    }
+
+    return successes;
+}
+
+void db2_statement_backend::collect_bulk_diagnostics()
+{
+    SQLCHAR sqlstate[SQL_SQLSTATE_SIZE + 1];
+    SQLCHAR message[SQL_MAX_MESSAGE_LENGTH + 1];
+
+    for (SQLSMALLINT recNum = 1;; ++recNum)
+    {
+        SQLINTEGER nativeErrorCode = 0;
+        SQLSMALLINT length = 0;
+        SQLRETURN cliRC = SQLGetDiagRec(SQL_HANDLE_STMT, hStmt, recNum,
+                                        sqlstate, &nativeErrorCode,
+                                        message, SQL_MAX_MESSAGE_LENGTH + 1,
+                                        &length);
+        if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO)
+        {
+            // SQL_NO_DATA means that there are no more records and we can't
+            // do anything about any errors here, so just stop.
+            break;
+        }
+
+        // For parameter arrays, this is the 1-based number of the parameter
+        // set the record is associated with, if it is known at all.
+        SQLINTEGER rowNum = SQL_ROW_NUMBER_UNKNOWN;
+        cliRC = SQLGetDiagField(SQL_HANDLE_STMT, hStmt, recNum,
+                                SQL_DIAG_ROW_NUMBER, &rowNum, SQL_IS_INTEGER, nullptr);
+        if ((cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO) ||
+                rowNum < 1 ||
+                static_cast<std::size_t>(rowNum) > bulkResults_.size())
+        {
+            continue;
+        }
+
+        db2_diag_record rec;
+        rec.sqlstate = reinterpret_cast<char const*>(sqlstate);
+        rec.native_error_code = nativeErrorCode;
+        rec.message = reinterpret_cast<char const*>(message);
+
+        bulkResults_[rowNum - 1].diagnostics.push_back(std::move(rec));
+    }
+}
+
+std::size_t db2_statement_backend::get_bulk_errors_count() const
+{
+    return static_cast<std::size_t>(std::count_if(bulkResults_.begin(), bulkResults_.end(),
+        [](db2_bulk_row_result const& r) { return r.status == SQL_PARAM_ERROR; }));
+}
+
 long long db2_statement_backend::get_affected_rows()
 {
+    if (rowsAffected_ != -1)
+    {
+        return rowsAffected_;
+    }
+
     SQLLEN rows;
 
     SQLRETURN cliRC = SQLRowCount(hStmt, &rows);
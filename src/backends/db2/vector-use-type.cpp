@@ -342,6 +342,7 @@ void db2_vector_use_type_backend::pre_use(indicator const *ind)
 
     SQLINTEGER arraySize = (SQLINTEGER)indVec.size();
     SQLSetStmtAttr(statement_.hStmt, SQL_ATTR_PARAMSET_SIZE, db2::int_as_ptr(arraySize), 0);
+    statement_.prepare_bulk_status(indVec.size());
 
     SQLRETURN cliRC = SQLBindParameter(statement_.hStmt, static_cast<SQLUSMALLINT>(position),
                                     SQL_PARAM_INPUT, cType, sqlType, size, 0,
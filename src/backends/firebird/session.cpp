@@ -7,7 +7,9 @@
 
 #include "soci/firebird/soci-firebird.h"
 #include "firebird/error-firebird.h"
+#include "soci-cstrtoi.h"
 #include "soci/session.h"
+#include <cstdlib>
 #include <map>
 #include <string>
 
@@ -36,6 +38,7 @@ void setDPBOption(std::string& dpb, int const option, std::string const & value)
 firebird_session_backend::firebird_session_backend(
     connection_parameters const & parameters) : dbhp_(0), trhp_(0)
                                          , decimals_as_strings_(false)
+                                         , stmtCacheSize_(0)
 {
     auto params = parameters;
     params.extract_options_from_space_separated_string();
@@ -82,6 +85,15 @@ firebird_session_backend::firebird_session_backend(
     {
         decimals_as_strings_ = param == "1" || param == "Y" || param == "y";
     }
+
+    if (params.get_option("stmt_cache_size", param))
+    {
+        if (!details::cstring_to_unsigned(stmtCacheSize_, param.c_str()))
+        {
+            cleanUp();
+            throw soci_error("Invalid statement cache size value \"" + param + "\".");
+        }
+    }
 }
 
 
@@ -149,10 +161,66 @@ isc_tr_handle* firebird_session_backend::current_transaction()
     return &trhp_;
 }
 
+bool firebird_session_backend::take_cached_statement(std::string const & key,
+    firebird_cached_statement & stmt)
+{
+    for (auto it = stmtCache_.begin(); it != stmtCache_.end(); ++it)
+    {
+        if (it->first == key)
+        {
+            stmt = it->second;
+            stmtCache_.erase(it);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+namespace
+{
+
+void freeCachedStatement(firebird_cached_statement & stmt)
+{
+    // Errors are ignored here as there is nothing to be done about them and
+    // the statement is not going to be used anyhow.
+    ISC_STATUS stat[ISC_STATUS_LENGTH];
+    isc_dsql_free_statement(stat, &stmt.stmtp, DSQL_drop);
+
+    free(stmt.sqldap);
+    free(stmt.sqlda2p);
+}
+
+} // namespace anonymous
+
+void firebird_session_backend::cache_statement(std::string const & key,
+    firebird_cached_statement & stmt)
+{
+    if (stmtCache_.size() >= stmtCacheSize_)
+    {
+        freeCachedStatement(stmtCache_.back().second);
+        stmtCache_.pop_back();
+    }
+
+    stmtCache_.emplace_front(key, stmt);
+}
+
+void firebird_session_backend::clear_statement_cache()
+{
+    for (auto& entry : stmtCache_)
+    {
+        freeCachedStatement(entry.second);
+    }
+
+    stmtCache_.clear();
+}
+
 void firebird_session_backend::cleanUp()
 {
     ISC_STATUS stat[ISC_STATUS_LENGTH];
 
+    clear_statement_cache();
+
     // at the end of session our transaction is finally commited.
     if (trhp_ != 0)
     {
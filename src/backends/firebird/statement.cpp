@@ -8,11 +8,19 @@
 #include "soci/firebird/soci-firebird.h"
 #include "soci-ssize.h"
 #include "firebird/error-firebird.h"
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 
 #include <fmt/format.h>
 
+// Batch API is only available since Firebird 4.
+#if defined(FB_API_VER) && FB_API_VER >= 40
+    #define SOCI_FIREBIRD_HAS_BATCH
+    #include <firebird/Interface.h>
+#endif
+
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::firebird;
@@ -40,6 +48,13 @@ void firebird_statement_backend::prepareSQLDA(XSQLDA ** sqldap, short size)
 
 void firebird_statement_backend::alloc()
 {
+    // When using the statement cache, the handle is either reused or
+    // allocated in prepare().
+    if (session_.get_statement_cache_size() != 0)
+    {
+        return;
+    }
+
     ISC_STATUS stat[ISC_STATUS_LENGTH];
 
     if (isc_dsql_allocate_statement(stat, &session_.dbhp_, &stmtp_))
@@ -52,8 +67,42 @@ void firebird_statement_backend::clean_up()
 {
     rowsAffectedBulk_ = -1LL;
 
+    release_statement();
+}
+
+void firebird_statement_backend::release_statement()
+{
     ISC_STATUS stat[ISC_STATUS_LENGTH];
 
+    if (stmtp_ != 0 && !cacheKey_.empty())
+    {
+        // Close the cursor, if any, but keep the statement itself prepared.
+        if (isc_dsql_free_statement(stat, &stmtp_, DSQL_close))
+        {
+            if (check_iscerror(stat, isc_dsql_cursor_close_err) == false)
+            {
+                throw_iscerror(stat);
+            }
+        }
+
+        firebird_cached_statement cached;
+        cached.stmtp = stmtp_;
+        cached.sqldap = sqldap_;
+        cached.sqlda2p = sqlda2p_;
+        cached.names.swap(names_);
+
+        stmtp_ = 0;
+        sqldap_ = nullptr;
+        sqlda2p_ = nullptr;
+
+        std::string key;
+        key.swap(cacheKey_);
+
+        session_.cache_statement(key, cached);
+
+        return;
+    }
+
     if (stmtp_ != 0)
     {
         if (isc_dsql_free_statement(stat, &stmtp_, DSQL_drop))
@@ -266,6 +315,8 @@ void firebird_statement_backend::rewriteQuery(
         // parameters in ddl
         if (stType == isc_info_sql_stmt_ddl)
         {
+            isDDL_ = true;
+
             // this statement is a DDL - we can't rewrite named parameters
             // so, we will use original query
             buffer.resize(query.size() + 1);
@@ -290,9 +341,77 @@ void firebird_statement_backend::prepare(std::string const & query,
                                          statement_type /* eType */)
 {
     //std::cerr << "prepare: query=" << query << std::endl;
+    if (session_.get_statement_cache_size() == 0)
+    {
+        prepare_statement(query);
+    }
+    else
+    {
+        // The same query can be prepared differently depending on whether
+        // it is a procedure call or not, so the key must take it into account.
+        std::string key(1, procedure_ ? 'P' : 'Q');
+        key += query;
+
+        // Give back the statement previously prepared using this object, if
+        // any, before preparing the new one.
+        release_statement();
+
+        firebird_cached_statement cached;
+        if (!session_.take_cached_statement(key, cached))
+        {
+            ISC_STATUS stat[ISC_STATUS_LENGTH];
+            if (isc_dsql_allocate_statement(stat, &session_.dbhp_, &stmtp_))
+            {
+                throw_iscerror(stat);
+            }
+
+            prepare_statement(query);
+
+            // DDL statements are not worth caching and, worse, prevent any
+            // other DDL statements affecting the same objects from executing
+            // successfully while they're kept alive, and so does any other
+            // cached statement, so get rid of all of them.
+            if (isDDL_)
+            {
+                session_.clear_statement_cache();
+            }
+            else
+            {
+                cacheKey_ = key;
+            }
+        }
+        else
+        {
+            stmtp_ = cached.stmtp;
+            sqldap_ = cached.sqldap;
+            sqlda2p_ = cached.sqlda2p;
+            names_.swap(cached.names);
+
+            procedure_ = false;
+            cacheKey_ = key;
+        }
+    }
+
+    // prepare buffers for indicators
+    inds_.clear();
+    inds_.resize(sqldap_->sqld);
+
+    // reset types of into buffers
+    intoType_ = eStandard;
+    intos_.resize(0);
+
+    // reset types of use buffers
+    useType_ = eStandard;
+    uses_.resize(0);
+}
+
+void firebird_statement_backend::prepare_statement(std::string const & query)
+{
     // clear named parametes
     names_.clear();
 
+    isDDL_ = false;
+
     std::vector<char> queryBuffer;
 
     // modify query's syntax and prepare buffer for use with
@@ -340,18 +459,6 @@ void firebird_statement_backend::prepare(std::string const & query,
             throw_iscerror(stat);
         }
     }
-
-    // prepare buffers for indicators
-    inds_.clear();
-    inds_.resize(sqldap_->sqld);
-
-    // reset types of into buffers
-    intoType_ = eStandard;
-    intos_.resize(0);
-
-    // reset types of use buffers
-    useType_ = eStandard;
-    uses_.resize(0);
 }
 
 
@@ -408,31 +515,36 @@ firebird_statement_backend::execute(int number)
     {
         rowsAffectedBulk_ = 0;
 
-        // Here we have to explicitly loop to achieve the
-        // effect of inserting or updating with vector use elements.
         const int rows = isize(*static_cast<firebird_vector_use_type_backend*>(uses_[0]));
-        for (current_row_ = 0; current_row_ < rows; ++current_row_)
+
+        // Sending all rows at once is much faster, but if this is not
+        // possible, we have to explicitly loop to achieve the effect of
+        // inserting or updating with vector use elements.
+        if (!execute_batch(rows))
         {
-            // first we have to prepare input parameters
-            for (std::size_t col=0; col<usize; ++col)
+            for (current_row_ = 0; current_row_ < rows; ++current_row_)
             {
-                static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(current_row_);
-            }
+                // first we have to prepare input parameters
+                for (std::size_t col=0; col<usize; ++col)
+                {
+                    static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(current_row_);
+                }
 
-            // then execute query
-            if (isc_dsql_execute(stat, session_.current_transaction(), &stmtp_, SQL_DIALECT_V6, t))
-            {
-                throw_iscerror(stat);
-            }
-            else
-            {
-                // Don't call get_affected_rows() here, because it would return
-                // the current value of rowsAffectedBulk_ itself.
-                rowsAffectedBulk_ += get_last_row_count();
+                // then execute query
+                if (isc_dsql_execute(stat, session_.current_transaction(), &stmtp_, SQL_DIALECT_V6, t))
+                {
+                    throw_iscerror(stat);
+                }
+                else
+                {
+                    // Don't call get_affected_rows() here, because it would return
+                    // the current value of rowsAffectedBulk_ itself.
+                    rowsAffectedBulk_ += get_last_row_count();
+                }
+                // soci does not allow bulk insert/update and bulk select operations
+                // in same query. So here, we know that into elements are not
+                // vectors. So, there is no need to fetch data here.
             }
-            // soci does not allow bulk insert/update and bulk select operations
-            // in same query. So here, we know that into elements are not
-            // vectors. So, there is no need to fetch data here.
         }
 
         current_row_ = -1;
@@ -472,6 +584,286 @@ firebird_statement_backend::execute(int number)
     }
 }
 
+#ifdef SOCI_FIREBIRD_HAS_BATCH
+
+namespace
+{
+
+// Throw an exception using the errors from the given status of the OO API.
+void throw_status_error(Firebird::IStatus* status)
+{
+    ISC_STATUS_ARRAY stat;
+
+    // Copy the status vector clusters while they fit into our array.
+    intptr_t const* const errors = status->getErrors();
+    std::size_t n = 0;
+    for (std::size_t i = 0; errors[i] != isc_arg_end; )
+    {
+        std::size_t const len = errors[i] == isc_arg_cstring ? 3 : 2;
+        if (n + len >= ISC_STATUS_LENGTH)
+            break;
+
+        for (std::size_t j = 0; j < len; ++j)
+            stat[n++] = errors[i++];
+    }
+    stat[n] = isc_arg_end;
+
+    throw_iscerror(stat);
+}
+
+// Simple RAII helper for the reference-counted interfaces.
+template <typename T>
+class fb_ref
+{
+public:
+    explicit fb_ref(T* ptr = nullptr) : ptr_(ptr) {}
+    ~fb_ref() { if (ptr_) ptr_->release(); }
+
+    fb_ref(fb_ref const&) = delete;
+    fb_ref& operator=(fb_ref const&) = delete;
+
+    T* operator->() const { return ptr_; }
+    T* get() const { return ptr_; }
+    void** ptr() { return reinterpret_cast<void**>(&ptr_); }
+
+private:
+    T* ptr_;
+};
+
+// And another one for the objects which must be disposed of.
+template <typename T>
+class fb_disposable
+{
+public:
+    explicit fb_disposable(T* ptr) : ptr_(ptr) {}
+    ~fb_disposable() { if (ptr_) ptr_->dispose(); }
+
+    fb_disposable(fb_disposable const&) = delete;
+    fb_disposable& operator=(fb_disposable const&) = delete;
+
+    T* operator->() const { return ptr_; }
+    T* get() const { return ptr_; }
+
+private:
+    T* const ptr_;
+};
+
+// Maximal size of the messages sent in a single batch: the default size of
+// the server-side batch buffer is 16MiB, but use a smaller value to leave some
+// room for the overhead.
+constexpr std::size_t maxBatchBytes = 8*1024*1024;
+
+} // anonymous namespace
+
+bool firebird_statement_backend::execute_batch(int rows)
+{
+    using namespace Firebird;
+
+    // Batches can't be used with statements returning data and we don't
+    // bother with registering the blobs with them, so just use the usual
+    // code in these cases.
+    if (sqldap_->sqld != 0)
+    {
+        return false;
+    }
+
+    for (short i = 0; i < sqlda2p_->sqld; ++i)
+    {
+        if ((sqlda2p_->sqlvar[i].sqltype & ~1) == SQL_BLOB)
+        {
+            return false;
+        }
+    }
+
+    IMaster* const master = fb_get_master_interface();
+    fb_disposable<IStatus> statusImpl(master->getStatus());
+    CheckStatusWrapper status(statusImpl.get());
+
+    ISC_STATUS_ARRAY stat;
+
+    fb_ref<IStatement> stmt;
+    if (fb_get_statement_interface(stat, stmt.ptr(), &stmtp_))
+    {
+        // This may fail if the server doesn't support the new API.
+        return false;
+    }
+
+    fb_ref<ITransaction> tra;
+    if (fb_get_transaction_interface(stat, tra.ptr(), session_.current_transaction()))
+    {
+        throw_iscerror(stat);
+    }
+
+    // Ask for the number of rows affected by each message, we need it for
+    // get_affected_rows().
+    fb_disposable<IXpbBuilder> pb(master->getUtilInterface()->
+        getXpbBuilder(&status, IXpbBuilder::BATCH, nullptr, 0));
+    pb->insertInt(&status, IBatch::TAG_RECORD_COUNTS, 1);
+    if (status.getState() & IStatus::STATE_ERRORS)
+    {
+        throw_status_error(&status);
+    }
+
+    fb_ref<IBatch> batch(stmt->createBatch(&status, nullptr,
+        pb->getBufferLength(&status), pb->getBuffer(&status)));
+    if (status.getState() & IStatus::STATE_ERRORS)
+    {
+        // Batches are not supported by the server (it must be at least
+        // Firebird 4), fall back to executing the statement row by row.
+        return false;
+    }
+
+    fb_ref<IMessageMetadata> meta(batch->getMetadata(&status));
+    if (status.getState() & IStatus::STATE_ERRORS)
+    {
+        throw_status_error(&status);
+    }
+
+    // Compute the layout of the message: we copy the data from the buffers
+    // of XSQLDA, so their types must be the same.
+    unsigned const count = meta->getCount(&status);
+    if (count != static_cast<unsigned>(sqlda2p_->sqld))
+    {
+        return false;
+    }
+
+    std::vector<unsigned> offsets(count), nullOffsets(count), lengths(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        XSQLVAR const* const var = sqlda2p_->sqlvar + i;
+        int const sqltype = var->sqltype & ~1;
+
+        if ((meta->getType(&status, i) & ~1u) != static_cast<unsigned>(sqltype) ||
+                meta->getLength(&status, i) != static_cast<unsigned>(var->sqllen))
+        {
+            return false;
+        }
+
+        offsets[i] = meta->getOffset(&status, i);
+        nullOffsets[i] = meta->getNullOffset(&status, i);
+
+        // Varying strings are preceded by their length in both cases.
+        lengths[i] = var->sqllen;
+        if (sqltype == SQL_VARYING)
+        {
+            lengths[i] += sizeof(ISC_USHORT);
+        }
+    }
+
+    std::size_t const msgLen = meta->getAlignedLength(&status);
+    if (status.getState() & IStatus::STATE_ERRORS)
+    {
+        throw_status_error(&status);
+    }
+
+    int const rowsPerBatch = static_cast<int>(
+        std::max<std::size_t>(1, maxBatchBytes / msgLen));
+
+    std::vector<unsigned char> buffer;
+
+    // Send the given number of messages in the buffer, corresponding to the
+    // rows starting from the given one, to the server and execute them.
+    auto const send = [&](int first, int num)
+    {
+        if (num == 0)
+        {
+            return;
+        }
+
+        batch->add(&status, static_cast<unsigned>(num), buffer.data());
+        if (status.getState() & IStatus::STATE_ERRORS)
+        {
+            throw_status_error(&status);
+        }
+
+        fb_disposable<IBatchCompletionState> cs(batch->execute(&status, tra.get()));
+        if (status.getState() & IStatus::STATE_ERRORS)
+        {
+            throw_status_error(&status);
+        }
+
+        unsigned const processed = cs->getSize(&status);
+        for (unsigned n = 0; n < processed; ++n)
+        {
+            int const state = cs->getState(&status, n);
+            if (state > 0)
+            {
+                rowsAffectedBulk_ += state;
+            }
+        }
+
+        // By default, the batch stops at the first error, just as executing
+        // the rows one by one would do.
+        unsigned const errorPos = cs->findError(&status, 0);
+        if (errorPos != IBatchCompletionState::NO_MORE_ERRORS)
+        {
+            current_row_ = first + static_cast<int>(errorPos);
+
+            fb_disposable<IStatus> error(master->getStatus());
+            cs->getStatus(&status, error.get(), errorPos);
+            throw_status_error(error.get());
+        }
+    };
+
+    std::size_t const usize = uses_.size();
+
+    for (int first = 0; first < rows; first += rowsPerBatch)
+    {
+        int const last = std::min(rows, first + rowsPerBatch);
+
+        buffer.assign((last - first)*msgLen, 0);
+
+        for (current_row_ = first; current_row_ < last; ++current_row_)
+        {
+            try
+            {
+                for (std::size_t col = 0; col < usize; ++col)
+                {
+                    static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(current_row_);
+                }
+            }
+            catch (soci_error const&)
+            {
+                // Execute all the previous rows before reporting the error
+                // for this one, as would happen without using the batch.
+                int const errorRow = current_row_;
+                send(first, errorRow - first);
+                current_row_ = errorRow;
+                throw;
+            }
+
+            unsigned char* const msg = &buffer[(current_row_ - first)*msgLen];
+            for (unsigned i = 0; i < count; ++i)
+            {
+                XSQLVAR const* const var = sqlda2p_->sqlvar + i;
+
+                short const ind = *var->sqlind == -1 ? -1 : 0;
+                std::memcpy(msg + nullOffsets[i], &ind, sizeof(ind));
+                if (ind == 0)
+                {
+                    std::memcpy(msg + offsets[i], var->sqldata, lengths[i]);
+                }
+            }
+        }
+
+        // The row is unknown if the whole batch fails.
+        current_row_ = -1;
+
+        send(first, last - first);
+    }
+
+    return true;
+}
+
+#else // !SOCI_FIREBIRD_HAS_BATCH
+
+bool firebird_statement_backend::execute_batch(int /* rows */)
+{
+    return false;
+}
+
+#endif // SOCI_FIREBIRD_HAS_BATCH
+
 statement_backend::exec_fetch_result
 firebird_statement_backend::fetch(int number)
 {
@@ -485,6 +877,17 @@ firebird_statement_backend::fetch(int number)
         inds_[i].resize(number > 0 ? number : 1);
     }
 
+    // Values of some types can be copied directly into the vectors storage,
+    // check for this once before fetching all rows.
+    if (intoType_ == eVector)
+    {
+        for (void* into : intos_)
+        {
+            static_cast<firebird_vector_into_type_backend*>(
+                into)->prepareDirectFetch();
+        }
+    }
+
     // Here we have to explicitly loop to achieve the effect of fetching
     // vector into elements. After each fetch, we have to exchange data
     // with into buffers.
@@ -548,8 +951,12 @@ void firebird_statement_backend::exchangeData(bool gotData, int row)
             {
                 if (intoType_ == eVector)
                 {
-                    static_cast<firebird_vector_into_type_backend*>(
-                        intos_[i])->exchangeData(row);
+                    auto* const into =
+                        static_cast<firebird_vector_into_type_backend*>(intos_[i]);
+                    if (!into->exchangeDataDirect(row))
+                    {
+                        into->exchangeData(row);
+                    }
                 }
                 else
                 {
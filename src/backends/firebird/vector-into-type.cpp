@@ -8,6 +8,7 @@
 #include "soci/firebird/soci-firebird.h"
 #include "firebird/common.h"
 #include "soci-vector-helpers.h"
+#include <cstring>
 
 using namespace soci;
 using namespace soci::details;
@@ -149,6 +150,90 @@ void firebird_vector_into_type_backend::exchangeData(std::size_t row)
 
 }
 
+namespace // anonymous
+{
+
+template <typename T>
+char *getVectorData(void *p)
+{
+    std::vector<T> &v = *static_cast<std::vector<T> *>(p);
+    return reinterpret_cast<char *>(v.data());
+}
+
+} // namespace anonymous
+
+void firebird_vector_into_type_backend::prepareDirectFetch()
+{
+    XSQLVAR const *var = statement_.sqldap_->sqlvar+position_;
+
+    direct_ = eDirectNone;
+
+    short const sqltype = var->sqltype & ~1;
+    switch (type_)
+    {
+    case x_int16:
+        if (sqltype == SQL_SHORT && var->sqlscale == 0)
+        {
+            direct_ = eDirectCopy;
+            directData_ = getVectorData<int16_t>(data_);
+            directSize_ = sizeof(int16_t);
+        }
+        break;
+    case x_int32:
+        if (sqltype == SQL_LONG && var->sqlscale == 0)
+        {
+            direct_ = eDirectCopy;
+            directData_ = getVectorData<int32_t>(data_);
+            directSize_ = sizeof(int32_t);
+        }
+        break;
+    case x_int64:
+        if (sqltype == SQL_INT64 && var->sqlscale == 0)
+        {
+            direct_ = eDirectCopy;
+            directData_ = getVectorData<int64_t>(data_);
+            directSize_ = sizeof(int64_t);
+        }
+        break;
+    case x_double:
+        if (sqltype == SQL_DOUBLE)
+        {
+            direct_ = eDirectCopy;
+            directData_ = getVectorData<double>(data_);
+            directSize_ = sizeof(double);
+        }
+        break;
+    case x_stdstring:
+        if (sqltype == SQL_VARYING || sqltype == SQL_TEXT)
+        {
+            direct_ = eDirectString;
+            directData_ = static_cast<char *>(data_);
+            directSize_ = sqltype == SQL_TEXT ? var->sqllen : 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void firebird_vector_into_type_backend::exchangeStringDirect(std::size_t row)
+{
+    std::vector<std::string> &v =
+        *reinterpret_cast<std::vector<std::string> *>(directData_);
+
+    // Assign to the existing string to reuse its buffer, if any.
+    if (directSize_ != 0)
+    {
+        v[row].assign(buf_, directSize_);
+    }
+    else
+    {
+        short size;
+        std::memcpy(&size, buf_, sizeof(short));
+        v[row].assign(buf_ + sizeof(short), size);
+    }
+}
+
 void firebird_vector_into_type_backend::post_fetch(
     bool gotData, indicator * ind)
 {
@@ -21,6 +21,7 @@ using namespace soci::details;
 
 char const * soci::odbc_option_driver_complete = "odbc.driver_complete";
 char const * soci::odbc_option_parent_window = "odbc.parent_window";
+char const * soci::odbc_option_continue_on_error = "odbc.continue_on_error";
 
 namespace
 {
@@ -107,7 +108,7 @@ extract_soci_option(std::string& connectString,
 
 odbc_session_backend::odbc_session_backend(
     connection_parameters const & parameters)
-    : product_(prod_uninitialized)
+    : continueOnError_(false), product_(prod_uninitialized)
 {
     SQLRETURN rc;
 
@@ -153,6 +154,17 @@ odbc_session_backend::odbc_session_backend(
     // mode value.
     bool remember_completed = false;
 
+    // Unlike the options below, this one must be removed from the connection
+    // string even when reconnecting, as ODBC wouldn't understand it.
+    std::string continueOnErrorString = extract_soci_option(connectString,
+                                          soci::odbc_option_continue_on_error);
+    if (parameters.get_option(odbc_option_continue_on_error, continueOnErrorString)
+          || !continueOnErrorString.empty())
+    {
+      continueOnError_ = connection_parameters::is_true_value(
+          odbc_option_continue_on_error, continueOnErrorString);
+    }
+
     if (parameters.is_option_on(option_reconnect))
     {
       completion = SQL_DRIVER_NOPROMPT;
@@ -9,6 +9,7 @@
 #include "soci/soci-unicode.h"
 #include "soci/type-holder.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include <fmt/format.h>
@@ -20,7 +21,7 @@ using namespace soci::details;
 odbc_statement_backend::odbc_statement_backend(odbc_session_backend &session)
     : session_(session), hstmt_(nullptr), numRowsFetched_(0), fetchVectorByRows_(false),
       boundByName_(false), boundByPos_(false),
-      rowsAffected_(-1LL)
+      rowsAffected_(-1LL), continueOnError_(session.continueOnError_)
 {
 }
 
@@ -139,6 +140,9 @@ void odbc_statement_backend::prepare(std::string const & query,
 statement_backend::exec_fetch_result
 odbc_statement_backend::execute(int number)
 {
+    bulkResults_.clear();
+    error_row_ = -1;
+
     // Store the number of rows processed by this call and the operation result
     // for each of them.
     SQLULEN rows_processed = 0;
@@ -157,6 +161,12 @@ odbc_statement_backend::execute(int number)
 
     SQLRETURN rc = SQLExecute(hstmt_);
 
+    std::size_t bulkSuccesses = 0;
+    if (hasVectorUseElements_)
+    {
+        bulkSuccesses = update_bulk_results(status, rows_processed);
+    }
+
     // Don't use is_odbc_error() here, as SQL_SUCCESS_WITH_INFO indicates an
     // error if it corresponds to a partial update.
     if (rc != SQL_SUCCESS && rc != SQL_NO_DATA)
@@ -166,36 +176,15 @@ odbc_statement_backend::execute(int number)
         const odbc_soci_error err(SQL_HANDLE_STMT, hstmt_, "executing statement");
 
         bool error = true;
-        if (rc == SQL_SUCCESS_WITH_INFO)
+        if (hasVectorUseElements_)
         {
             // Check for partial update when using array parameters.
-            if (hasVectorUseElements_)
-            {
-                rowsAffected_ = 0;
-
-                error_row_ = -1;
-                for (SQLULEN i = 0; i < rows_processed; ++i)
-                {
-                    switch (status[i])
-                    {
-                        case SQL_PARAM_SUCCESS:
-                        case SQL_PARAM_SUCCESS_WITH_INFO:
-                            ++rowsAffected_;
-                            break;
-
-                        case SQL_PARAM_ERROR:
-                            if (error_row_ == -1)
-                                error_row_ = soci_cast<int, SQLULEN>::cast(i);
-                            break;
-
-                        case SQL_PARAM_UNUSED:
-                        case SQL_PARAM_DIAG_UNAVAILABLE:
-                            // We shouldn't get those, normally, but just
-                            // ignore them if we do.
-                            break;
-                    }
-                }
+            rowsAffected_ = bulkSuccesses;
 
+            collect_bulk_diagnostics();
+
+            if (rc == SQL_SUCCESS_WITH_INFO)
+            {
                 // In principle, it is possible to get success with info for an
                 // operation which succeeded for all rows -- even though this
                 // hasn't been observed so far. In this case, we shouldn't
@@ -203,15 +192,23 @@ odbc_statement_backend::execute(int number)
                 if (error_row_ == -1)
                     error = false;
             }
-            else
+
+            // Some drivers return SQL_ERROR even if only some rows failed, so
+            // don't throw, if asked not to, as long as the errors can be
+            // attributed to the individual rows.
+            if (continueOnError_ && error_row_ != -1)
             {
-                // This is a weird case which has never been observed so far
-                // and it's not clear what it might correspond to, but don't
-                // handle it as an error to avoid throwing spurious exceptions
-                // when there is no real problem.
-                error = false;
+                return ef_success;
             }
         }
+        else if (rc == SQL_SUCCESS_WITH_INFO)
+        {
+            // This is a weird case which has never been observed so far
+            // and it's not clear what it might correspond to, but don't
+            // handle it as an error to avoid throwing spurious exceptions
+            // when there is no real problem.
+            error = false;
+        }
         else
         {
             // If the statement failed completely, no rows should have been
@@ -332,6 +329,87 @@ odbc_statement_backend::fetch(int number)
     return res;
 }
 
+std::size_t
+odbc_statement_backend::update_bulk_results(std::vector<SQLUSMALLINT> const& status,
+                                            SQLULEN rowsProcessed)
+{
+    std::size_t successes = 0;
+
+    bulkResults_.resize(rowsProcessed);
+    error_row_ = -1;
+    for (SQLULEN i = 0; i < rowsProcessed; ++i)
+    {
+        bulkResults_[i].status = status[i];
+
+        switch (status[i])
+        {
+            case SQL_PARAM_SUCCESS:
+            case SQL_PARAM_SUCCESS_WITH_INFO:
+                ++successes;
+                break;
+
+            case SQL_PARAM_ERROR:
+                if (error_row_ == -1)
+                    error_row_ = soci_cast<int, SQLULEN>::cast(i);
+                break;
+
+            case SQL_PARAM_UNUSED:
+            case SQL_PARAM_DIAG_UNAVAILABLE:
+                // We shouldn't get those, normally, but just
+                // ignore them if we do.
+                break;
+        }
+    }
+
+    return successes;
+}
+
+void odbc_statement_backend::collect_bulk_diagnostics()
+{
+    SQLCHAR sqlstate[SQL_SQLSTATE_SIZE + 1];
+    SQLCHAR message[SQL_MAX_MESSAGE_LENGTH + 1];
+
+    for (SQLSMALLINT recNum = 1;; ++recNum)
+    {
+        SQLINTEGER nativeErrorCode = 0;
+        SQLSMALLINT length = 0;
+        SQLRETURN rc = SQLGetDiagRecA(SQL_HANDLE_STMT, hstmt_, recNum,
+                                      sqlstate, &nativeErrorCode,
+                                      message, SQL_MAX_MESSAGE_LENGTH + 1,
+                                      &length);
+        if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO)
+        {
+            // SQL_NO_DATA means that there are no more records and we can't
+            // do anything about any errors here, so just stop.
+            break;
+        }
+
+        // For parameter arrays, this is the 1-based number of the parameter
+        // set the record is associated with, if it is known at all.
+        SQLLEN rowNum = SQL_ROW_NUMBER_UNKNOWN;
+        rc = SQLGetDiagField(SQL_HANDLE_STMT, hstmt_, recNum,
+                             SQL_DIAG_ROW_NUMBER, &rowNum, SQL_IS_INTEGER, nullptr);
+        if (is_odbc_error(rc) || rowNum < 1 ||
+                static_cast<std::size_t>(rowNum) > bulkResults_.size())
+        {
+            continue;
+        }
+
+        odbc_diag_record rec;
+        rec.sqlstate = reinterpret_cast<char const*>(sqlstate);
+        rec.native_error_code = nativeErrorCode;
+        rec.message = reinterpret_cast<char const*>(message);
+
+        bulkResults_[rowNum - 1].diagnostics.push_back(std::move(rec));
+    }
+}
+
+std::size_t odbc_statement_backend::get_bulk_errors_count() const
+{
+    return static_cast<std::size_t>(std::count_if(bulkResults_.begin(), bulkResults_.end(),
+        [](odbc_bulk_row_result const& r) { return r.status == SQL_PARAM_ERROR; }));
+}
+
 long long odbc_statement_backend::get_affected_rows()
 {
     return rowsAffected_;
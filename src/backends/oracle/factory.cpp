@@ -103,8 +103,85 @@ oracle_session_backend * oracle_backend_factory::make_session(
         ncharset = charset_code(value);
     }
 
-    return new oracle_session_backend(serviceName, userName, password,
-        mode, decimals_as_strings, charset, ncharset);
+    ub4 stmtCacheSize = 0;
+    if (params.get_option("stmt_cache_size", value))
+    {
+        if (!cstring_to_unsigned(stmtCacheSize, value.c_str()))
+        {
+            throw soci_error("Invalid statement cache size.");
+        }
+    }
+
+    ub4 prefetchRows = 0;
+    if (params.get_option("prefetch_rows", value))
+    {
+        if (!cstring_to_unsigned(prefetchRows, value.c_str()))
+        {
+            throw soci_error("Invalid number of rows to prefetch.");
+        }
+    }
+
+    ub4 prefetchMemory = 0;
+    if (params.get_option("prefetch_memory", value))
+    {
+        if (!cstring_to_unsigned(prefetchMemory, value.c_str()))
+        {
+            throw soci_error("Invalid amount of memory to use for prefetching.");
+        }
+    }
+
+    oracle_session_backend * backend;
+
+    ub4 poolMax = 0;
+    if (params.get_option("session_pool_max", value))
+    {
+        if (!cstring_to_unsigned(poolMax, value.c_str()) || poolMax == 0)
+        {
+            throw soci_error("Invalid maximal session pool size.");
+        }
+
+        ub4 poolMin = 1;
+        if (params.get_option("session_pool_min", value))
+        {
+            if (!cstring_to_unsigned(poolMin, value.c_str()) || poolMin > poolMax)
+            {
+                throw soci_error("Invalid minimal session pool size.");
+            }
+        }
+
+        ub4 poolIncrement = 1;
+        if (params.get_option("session_pool_increment", value))
+        {
+            if (!cstring_to_unsigned(poolIncrement, value.c_str()))
+            {
+                throw soci_error("Invalid session pool increment.");
+            }
+        }
+
+        if (mode != OCI_DEFAULT)
+        {
+            throw soci_error("Session pool can't be used with non-default mode.");
+        }
+
+        backend = new oracle_session_backend(
+            oracle_session_pool::get(serviceName, userName, password,
+                poolMin, poolMax, poolIncrement,
+                charset, ncharset, stmtCacheSize),
+            decimals_as_strings);
+    }
+    else
+    {
+        backend = new oracle_session_backend(
+            serviceName, userName, password,
+            mode, decimals_as_strings, charset, ncharset, stmtCacheSize);
+    }
+
+    backend->set_prefetch_rows(prefetchRows);
+    backend->set_prefetch_memory(prefetchMemory);
+
+    backend->set_continue_on_error(params.is_option_on("continue_on_error"));
+
+    return backend;
 }
 
 oracle_backend_factory const soci::oracle;
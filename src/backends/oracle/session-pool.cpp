@@ -0,0 +1,236 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/oracle/soci-oracle.h"
+#include "handle.h"
+#include "soci-mutex.h"
+#include <map>
+#include <vector>
+
+#include <fmt/format.h>
+
+using namespace soci;
+using namespace soci::details;
+using namespace soci::details::oracle;
+
+namespace // unnamed
+{
+
+// Convert the string assumed to be in UTF-8 to the given charset, if any.
+std::string convert_to_charset(OCIEnv *envhp, OCIError *errhp,
+    ub2 charset, std::string const & s)
+{
+    if (charset == 0 || s.empty())
+    {
+        return s;
+    }
+
+    // See the comment in oracle_session_backend ctor.
+    const int defaultSourceCharSetId = 871;
+
+    // UTF-8 to UTF-16 conversion can require up to twice as many bytes, while
+    // converting to single byte charsets never requires more.
+    std::vector<char> buf(2*s.size());
+    size_t len = 0;
+
+    sword res = OCINlsCharSetConvert(envhp, errhp,
+        charset, buf.data(), buf.size(),
+        defaultSourceCharSetId, s.c_str(), s.size(), &len);
+    if (res != OCI_SUCCESS)
+    {
+        throw oracle_soci_error(res, errhp);
+    }
+
+    return std::string(buf.data(), len);
+}
+
+} // unnamed namespace
+
+oracle_session_pool::oracle_session_pool(std::string const & serviceName,
+    std::string const & userName, std::string const & password,
+    ub4 minSessions, ub4 maxSessions, ub4 increment,
+    ub2 charset, ub2 ncharset, ub4 stmtCacheSize)
+    : envhp_(nullptr), errhp_(nullptr), spoolhp_(nullptr),
+      poolName_(nullptr), poolNameLen_(0),
+      stmtCacheSize_(stmtCacheSize)
+{
+    // Unlike the environment created for a standalone session, this one will
+    // be used by the sessions running in different threads, so we must let
+    // OCI serialize access to it.
+    sword res = OCIEnvNlsCreate(&envhp_, OCI_THREADED,
+        nullptr, nullptr, nullptr, nullptr, 0, nullptr, charset, ncharset);
+    if (res != OCI_SUCCESS)
+    {
+        throw soci_error("Cannot create environment");
+    }
+
+    res = OCIHandleAlloc(envhp_, reinterpret_cast<dvoid**>(&errhp_),
+        OCI_HTYPE_ERROR, 0, nullptr);
+    if (res != OCI_SUCCESS)
+    {
+        clean_up();
+        throw soci_error("Cannot create error handle");
+    }
+
+    res = OCIHandleAlloc(envhp_, reinterpret_cast<dvoid**>(&spoolhp_),
+        OCI_HTYPE_SPOOL, 0, nullptr);
+    if (res != OCI_SUCCESS)
+    {
+        clean_up();
+        throw soci_error("Cannot create session pool handle");
+    }
+
+    std::string nlsService, nlsUserName, nlsPassword;
+    try
+    {
+        nlsService = convert_to_charset(envhp_, errhp_, charset, serviceName);
+        nlsUserName = convert_to_charset(envhp_, errhp_, charset, userName);
+        nlsPassword = convert_to_charset(envhp_, errhp_, charset, password);
+    }
+    catch (oracle_soci_error const&)
+    {
+        clean_up();
+        throw;
+    }
+
+    ub4 mode = OCI_SPC_HOMOGENEOUS;
+    if (stmtCacheSize_ != 0)
+    {
+        mode |= OCI_SPC_STMTCACHE;
+    }
+
+    res = OCISessionPoolCreate(envhp_, errhp_, spoolhp_,
+        &poolName_, &poolNameLen_,
+        reinterpret_cast<OraText const*>(nlsService.c_str()),
+        static_cast<ub4>(nlsService.size()),
+        minSessions, maxSessions, increment,
+        reinterpret_cast<OraText const*>(nlsUserName.c_str()),
+        static_cast<ub4>(nlsUserName.size()),
+        reinterpret_cast<OraText const*>(nlsPassword.c_str()),
+        static_cast<ub4>(nlsPassword.size()),
+        mode);
+    if (res != OCI_SUCCESS && res != OCI_SUCCESS_WITH_INFO)
+    {
+        oracle_soci_error err(res, errhp_);
+        clean_up();
+        throw err;
+    }
+
+    if (stmtCacheSize_ != 0)
+    {
+        res = OCIAttrSet(spoolhp_, OCI_HTYPE_SPOOL, &stmtCacheSize_,
+            0, OCI_ATTR_SPOOL_STMTCACHESIZE, errhp_);
+        if (res != OCI_SUCCESS)
+        {
+            oracle_soci_error err(res, errhp_);
+            clean_up();
+            throw err;
+        }
+    }
+
+    // Wait for a session to become available when the pool is exhausted
+    // instead of failing immediately (this is the default, but make it
+    // explicit as the code acquiring sessions relies on it).
+    ub1 getMode = OCI_SPOOL_ATTRVAL_WAIT;
+    res = OCIAttrSet(spoolhp_, OCI_HTYPE_SPOOL, &getMode,
+        0, OCI_ATTR_SPOOL_GETMODE, errhp_);
+    if (res != OCI_SUCCESS)
+    {
+        oracle_soci_error err(res, errhp_);
+        clean_up();
+        throw err;
+    }
+}
+
+oracle_session_pool::~oracle_session_pool()
+{
+    clean_up();
+}
+
+void oracle_session_pool::clean_up()
+{
+    if (poolName_ != nullptr)
+    {
+        OCISessionPoolDestroy(spoolhp_, errhp_, OCI_SPD_FORCE);
+        poolName_ = nullptr;
+    }
+
+    if (spoolhp_) { OCIHandleFree(spoolhp_, OCI_HTYPE_SPOOL); }
+    if (errhp_) { OCIHandleFree(errhp_, OCI_HTYPE_ERROR); }
+    if (envhp_) { OCIHandleFree(envhp_, OCI_HTYPE_ENV); }
+
+    spoolhp_ = nullptr;
+    errhp_ = nullptr;
+    envhp_ = nullptr;
+}
+
+std::shared_ptr<oracle_session_pool> oracle_session_pool::get(
+    std::string const & serviceName,
+    std::string const & userName, std::string const & password,
+    ub4 minSessions, ub4 maxSessions, ub4 increment,
+    ub2 charset, ub2 ncharset, ub4 stmtCacheSize)
+{
+    // All pools are kept in this map as long as they're used by at least one
+    // session. Note that the key includes all the parameters, so that
+    // different pools are used for the sessions with different parameters.
+    static soci_mutex_t mutex;
+    static std::map<std::string, std::weak_ptr<oracle_session_pool>> pools;
+
+    std::string const key = fmt::format("{}\n{}\n{}\n{}:{}:{}:{}:{}:{}",
+        serviceName, userName, password,
+        minSessions, maxSessions, increment,
+        charset, ncharset, stmtCacheSize);
+
+    soci_scoped_lock lock(&mutex);
+
+    std::weak_ptr<oracle_session_pool>& entry = pools[key];
+    std::shared_ptr<oracle_session_pool> pool = entry.lock();
+    if (!pool)
+    {
+        // Remove any other pools which are not used any longer.
+        for (auto it = pools.begin(); it != pools.end(); )
+        {
+            if (it->second.expired() && &it->second != &entry)
+                it = pools.erase(it);
+            else
+                ++it;
+        }
+
+        pool = std::make_shared<oracle_session_pool>(serviceName,
+            userName, password, minSessions, maxSessions, increment,
+            charset, ncharset, stmtCacheSize);
+        entry = pool;
+    }
+
+    return pool;
+}
+
+ub4 oracle_session_pool::get_pool_attr(int attr) const
+{
+    // Use a separate error handle as this function can be called from any
+    // thread.
+    handle<OCIError> errh(envhp_);
+
+    ub4 value = 0;
+    sword res = OCIAttrGet(spoolhp_, OCI_HTYPE_SPOOL, &value, nullptr,
+        static_cast<ub4>(attr), errh);
+    if (res != OCI_SUCCESS)
+    {
+        throw oracle_soci_error(res, errh);
+    }
+
+    return value;
+}
+
+ub4 oracle_session_pool::get_open_count() const
+{
+    return get_pool_attr(OCI_ATTR_SPOOL_OPEN_COUNT);
+}
+
+ub4 oracle_session_pool::get_busy_count() const
+{
+    return get_pool_attr(OCI_ATTR_SPOOL_BUSY_COUNT);
+}
@@ -118,9 +118,9 @@ sb4 fo_callback(void * /* svchp */, void * /* envhp */, void * fo_ctx,
 
 oracle_session_backend::oracle_session_backend(std::string const & serviceName,
     std::string const & userName, std::string const & password, int mode,
-    bool decimals_as_strings, ub2 charset, ub2 ncharset)
+    bool decimals_as_strings, ub2 charset, ub2 ncharset, ub4 stmtCacheSize)
     : envhp_(nullptr), srvhp_(nullptr), errhp_(nullptr), svchp_(nullptr), usrhp_(nullptr),
-      decimals_as_strings_(decimals_as_strings)
+      decimals_as_strings_(decimals_as_strings), stmtCacheSize_(stmtCacheSize)
 {
     // assume service/user/password are utf8-compatible already
     const int defaultSourceCharSetId = 871;
@@ -326,6 +326,13 @@ oracle_session_backend::oracle_session_backend(std::string const & serviceName,
         }
     }
 
+    // statement cache must be enabled when beginning the session, its size
+    // is set below
+    if (stmtCacheSize_ != 0)
+    {
+        mode |= OCI_STMT_CACHE;
+    }
+
     // begin the session
     res = OCISessionBegin(svchp_, errhp_, usrhp_,
         credentialType, mode);
@@ -345,6 +352,37 @@ oracle_session_backend::oracle_session_backend(std::string const & serviceName,
         clean_up();
         throw err;
     }
+
+    if (stmtCacheSize_ != 0)
+    {
+        res = OCIAttrSet(svchp_, OCI_HTYPE_SVCCTX, &stmtCacheSize_,
+            0, OCI_ATTR_STMTCACHESIZE, errhp_);
+        if (res != OCI_SUCCESS)
+        {
+            oracle_soci_error err(res, errhp_);
+            clean_up();
+            throw err;
+        }
+    }
+}
+
+oracle_session_backend::oracle_session_backend(
+    std::shared_ptr<oracle_session_pool> const & pool,
+    bool decimals_as_strings)
+    : envhp_(pool->envhp_), srvhp_(nullptr), errhp_(nullptr), svchp_(nullptr), usrhp_(nullptr),
+      decimals_as_strings_(decimals_as_strings), pool_(pool),
+      stmtCacheSize_(pool->get_statement_cache_size())
+{
+    // The environment is shared with the pool, but each session needs its
+    // own error handle as they can be used from different threads.
+    sword res = OCIHandleAlloc(envhp_, reinterpret_cast<dvoid**>(&errhp_),
+        OCI_HTYPE_ERROR, 0, nullptr);
+    if (res != OCI_SUCCESS)
+    {
+        throw soci_error("Cannot create error handle");
+    }
+
+    // Note that the session itself is only acquired when it's needed.
 }
 
 oracle_session_backend::~oracle_session_backend()
@@ -352,8 +390,82 @@ oracle_session_backend::~oracle_session_backend()
     clean_up();
 }
 
+void oracle_session_backend::acquire_pooled_session()
+{
+    if (!pool_ || svchp_ != nullptr)
+    {
+        return;
+    }
+
+    ub4 mode = OCI_SESSGET_SPOOL;
+    if (stmtCacheSize_ != 0)
+    {
+        mode |= OCI_SESSGET_STMTCACHE;
+    }
+
+    // The pool is homogeneous, so no authentication info is needed.
+    sword res = OCISessionGet(envhp_, errhp_, &svchp_, nullptr,
+        pool_->poolName_, pool_->poolNameLen_,
+        nullptr, 0, nullptr, nullptr, nullptr, mode);
+    if (res != OCI_SUCCESS && res != OCI_SUCCESS_WITH_INFO)
+    {
+        svchp_ = nullptr;
+        throw oracle_soci_error(res, errhp_);
+    }
+}
+
+void oracle_session_backend::release_pooled_session()
+{
+    if (!pool_ || svchp_ == nullptr)
+    {
+        return;
+    }
+
+    // Don't leave any uncommitted changes in the session given back to the
+    // pool and use the result of doing this to check if the session is still
+    // usable: if not, drop it instead of returning it to the pool.
+    ub4 mode = OCI_DEFAULT;
+    if (OCITransRollback(svchp_, errhp_, OCI_DEFAULT) != OCI_SUCCESS)
+    {
+        mode = OCI_SESSRLS_DROPSESS;
+    }
+
+    OCISessionRelease(svchp_, errhp_, nullptr, 0, mode);
+    svchp_ = nullptr;
+}
+
+void oracle_session_backend::on_pool_give_back()
+{
+    // The statements still existing would be executed using a different OCI
+    // session by the next user of this session if we released it, so keep it
+    // instead, but still don't leave any uncommitted changes in it.
+    if (statementsCount_ != 0)
+    {
+        if (pool_ && svchp_ != nullptr)
+        {
+            OCITransRollback(svchp_, errhp_, OCI_DEFAULT);
+        }
+
+        return;
+    }
+
+    release_pooled_session();
+}
+
 bool oracle_session_backend::is_connected()
 {
+    if (pool_)
+    {
+        try
+        {
+            acquire_pooled_session();
+        }
+        catch (oracle_soci_error const&)
+        {
+            return false;
+        }
+    }
+
     return OCIPing(svchp_, errhp_, OCI_DEFAULT) == OCI_SUCCESS;
 }
 
@@ -371,6 +483,12 @@ void oracle_session_backend::begin()
 
 void oracle_session_backend::commit()
 {
+    if (svchp_ == nullptr)
+    {
+        // Nothing to commit if the pooled session hasn't been acquired yet.
+        return;
+    }
+
     sword res = OCITransCommit(svchp_, errhp_, OCI_DEFAULT);
     if (res != OCI_SUCCESS)
     {
@@ -380,6 +498,11 @@ void oracle_session_backend::commit()
 
 void oracle_session_backend::rollback()
 {
+    if (svchp_ == nullptr)
+    {
+        return;
+    }
+
     sword res = OCITransRollback(svchp_, errhp_, OCI_DEFAULT);
     if (res != OCI_SUCCESS)
     {
@@ -389,6 +512,19 @@ void oracle_session_backend::rollback()
 
 void oracle_session_backend::clean_up()
 {
+    if (pool_)
+    {
+        release_pooled_session();
+
+        if (errhp_) { OCIHandleFree(errhp_, OCI_HTYPE_ERROR); }
+
+        // The environment belongs to the pool and is freed by it.
+        errhp_ = nullptr;
+        envhp_ = nullptr;
+        pool_.reset();
+        return;
+    }
+
     if (svchp_ != nullptr && errhp_ != nullptr && usrhp_ != nullptr)
     {
         OCISessionEnd(svchp_, errhp_, usrhp_, OCI_DEFAULT);
@@ -407,16 +543,22 @@ void oracle_session_backend::clean_up()
 
 oracle_statement_backend * oracle_session_backend::make_statement_backend()
 {
+    acquire_pooled_session();
+
     return new oracle_statement_backend(*this);
 }
 
 oracle_rowid_backend * oracle_session_backend::make_rowid_backend()
 {
+    acquire_pooled_session();
+
     return new oracle_rowid_backend(*this);
 }
 
 oracle_blob_backend * oracle_session_backend::make_blob_backend()
 {
+    acquire_pooled_session();
+
     return new oracle_blob_backend(*this);
 }
 
@@ -52,12 +52,28 @@ T get_oci_attr(handle<OCIHandle>& hp, int attr, OCIError* errhp)
 
 oracle_statement_backend::oracle_statement_backend(oracle_session_backend &session)
     : session_(session), stmtp_(nullptr), boundByName_(false), boundByPos_(false),
-      noData_(false)
+      noData_(false),
+      prefetchRows_(session.get_prefetch_rows()),
+      prefetchMemory_(session.get_prefetch_memory()),
+      continueOnError_(session.get_continue_on_error())
 {
+    ++session_.statementsCount_;
+}
+
+oracle_statement_backend::~oracle_statement_backend()
+{
+    --session_.statementsCount_;
 }
 
 void oracle_statement_backend::alloc()
 {
+    // When using the statement cache, the handle is returned by
+    // OCIStmtPrepare2() and so there is nothing to do here.
+    if (session_.get_statement_cache_size() != 0)
+    {
+        return;
+    }
+
     sword res = OCIHandleAlloc(session_.envhp_,
         reinterpret_cast<dvoid**>(&stmtp_),
         OCI_HTYPE_STMT, 0, nullptr);
@@ -72,7 +88,17 @@ void oracle_statement_backend::clean_up()
     // deallocate statement handle
     if (stmtp_ != nullptr)
     {
-        OCIHandleFree(stmtp_, OCI_HTYPE_STMT);
+        if (fromStmtCache_)
+        {
+            // This returns the statement to the cache instead of freeing it.
+            OCIStmtRelease(stmtp_, session_.errhp_, nullptr, 0, OCI_DEFAULT);
+            fromStmtCache_ = false;
+        }
+        else
+        {
+            OCIHandleFree(stmtp_, OCI_HTYPE_STMT);
+        }
+
         stmtp_ = nullptr;
     }
 
@@ -84,13 +110,75 @@ void oracle_statement_backend::prepare(std::string const &query,
     statement_type /* eType */)
 {
     sb4 stmtLen = static_cast<sb4>(query.size());
-    sword res = OCIStmtPrepare(stmtp_,
-        session_.errhp_,
-        reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
-        stmtLen, OCI_V7_SYNTAX, OCI_DEFAULT);
-    if (res != OCI_SUCCESS)
+    sword res;
+
+    // Use the statement cache if alloc() didn't allocate the handle.
+    if (stmtp_ == nullptr || fromStmtCache_)
     {
-        throw oracle_soci_error(res, session_.errhp_);
+        if (fromStmtCache_)
+        {
+            OCIStmtRelease(stmtp_, session_.errhp_, nullptr, 0, OCI_DEFAULT);
+            stmtp_ = nullptr;
+            fromStmtCache_ = false;
+        }
+
+        res = OCIStmtPrepare2(session_.svchp_, &stmtp_,
+            session_.errhp_,
+            reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
+            static_cast<ub4>(stmtLen), nullptr, 0, OCI_NTV_SYNTAX, OCI_DEFAULT);
+        if (res != OCI_SUCCESS && res != OCI_SUCCESS_WITH_INFO)
+        {
+            stmtp_ = nullptr;
+            throw oracle_soci_error(res, session_.errhp_);
+        }
+
+        fromStmtCache_ = true;
+    }
+    else
+    {
+        res = OCIStmtPrepare(stmtp_,
+            session_.errhp_,
+            reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
+            stmtLen, OCI_V7_SYNTAX, OCI_DEFAULT);
+        if (res != OCI_SUCCESS)
+        {
+            throw oracle_soci_error(res, session_.errhp_);
+        }
+    }
+
+    apply_prefetch_options();
+}
+
+void oracle_statement_backend::set_prefetch_rows(ub4 rows)
+{
+    prefetchRows_ = rows;
+
+    if (stmtp_ != nullptr && prefetchRows_ != 0)
+    {
+        set_statement_attr(prefetchRows_, OCI_ATTR_PREFETCH_ROWS);
+    }
+}
+
+void oracle_statement_backend::set_prefetch_memory(ub4 bytes)
+{
+    prefetchMemory_ = bytes;
+
+    if (stmtp_ != nullptr && prefetchMemory_ != 0)
+    {
+        set_statement_attr(prefetchMemory_, OCI_ATTR_PREFETCH_MEMORY);
+    }
+}
+
+void oracle_statement_backend::apply_prefetch_options()
+{
+    if (prefetchRows_ != 0)
+    {
+        set_statement_attr(prefetchRows_, OCI_ATTR_PREFETCH_ROWS);
+    }
+
+    if (prefetchMemory_ != 0)
+    {
+        set_statement_attr(prefetchMemory_, OCI_ATTR_PREFETCH_MEMORY);
     }
 }
 
@@ -98,6 +186,9 @@ statement_backend::exec_fetch_result oracle_statement_backend::execute(int numbe
 {
     ub4 mode = OCI_DEFAULT;
 
+    error_row_ = -1;
+    batchErrors_.clear();
+
     // We want to use OCI_BATCH_ERRORS for bulk operations in order to get
     // information about the row(s) which resulted in errors.
     if (hasVectorUseElements_)
@@ -116,33 +207,21 @@ statement_backend::exec_fetch_result oracle_statement_backend::execute(int numbe
         static_cast<ub4>(number), 0, nullptr, nullptr, mode);
 
     // For bulk operations, "success with info" is used even when some rows
-    // resulted in errors, so check for this and return error in this case.
-    if (hasVectorUseElements_ && res == OCI_SUCCESS_WITH_INFO)
-    {
-        // We don't handle multiple errors and only distinguish between not
-        // having any errors at all and having at least one. This is, of
-        // course, not ideal, but provides at least some information about the
-        // (first) error.
-        //
-        // Note that we have to use a different error handle to this call to
-        // avoid clobbering the error handle used for the statement itself.
-        handle<OCIError> errhTmp(session_.envhp_);
-        if (get_oci_attr<ub4>(stmtp_, OCI_ATTR_NUM_DML_ERRORS, errhTmp))
+    // resulted in errors, so check for this and return error in this case,
+    // unless we were asked to continue after them.
+    if (mode == OCI_BATCH_ERRORS && res == OCI_SUCCESS_WITH_INFO)
+    {
+        collect_batch_errors();
+
+        if (!batchErrors_.empty())
         {
-            handle<OCIError> errhRow(session_.envhp_);
-            sword res2 = OCIParamGet(session_.errhp_,
-                OCI_HTYPE_ERROR,
-                errhTmp,
-                errhRow.ptr(),
-                0
-            );
-            if (res2 != OCI_SUCCESS)
+            oracle_batch_error const& first = batchErrors_.front();
+            error_row_ = static_cast<int>(first.row);
+
+            if (!continueOnError_)
             {
-                throw oracle_soci_error(res2, errhTmp);
+                throw oracle_soci_error(first.message, first.error_code);
             }
-
-            error_row_ = get_oci_attr<ub4>(errhRow, OCI_ATTR_DML_ROW_OFFSET, errhTmp);
-            throw oracle_soci_error(res, errhRow);
         }
         //else: No errors, handle as success below.
     }
@@ -171,6 +250,40 @@ statement_backend::exec_fetch_result oracle_statement_backend::execute(int numbe
     }
 }
 
+void oracle_statement_backend::collect_batch_errors()
+{
+    // Note that we have to use a different error handle for these calls to
+    // avoid clobbering the error handle used for the statement itself.
+    handle<OCIError> errhTmp(session_.envhp_);
+    ub4 const numErrors = get_oci_attr<ub4>(stmtp_, OCI_ATTR_NUM_DML_ERRORS, errhTmp);
+
+    batchErrors_.reserve(numErrors);
+
+    handle<OCIError> errhRow(session_.envhp_);
+    for (ub4 i = 0; i < numErrors; ++i)
+    {
+        sword res = OCIParamGet(session_.errhp_,
+            OCI_HTYPE_ERROR,
+            errhTmp,
+            errhRow.ptr(),
+            i
+        );
+        if (res != OCI_SUCCESS)
+        {
+            throw oracle_soci_error(res, errhTmp);
+        }
+
+        oracle_batch_error error;
+        error.row = get_oci_attr<ub4>(errhRow, OCI_ATTR_DML_ROW_OFFSET, errhTmp);
+
+        oracle_soci_error const err(OCI_ERROR, errhRow);
+        error.error_code = err.get_backend_error_code();
+        error.message = err.get_error_message();
+
+        batchErrors_.push_back(error);
+    }
+}
+
 statement_backend::exec_fetch_result oracle_statement_backend::fetch(int number)
 {
     if (noData_)
@@ -203,6 +316,16 @@ T oracle_statement_backend::get_statement_attr(int attr) const
     return get_oci_attr<T>(stmtp_, attr, session_.errhp_);
 }
 
+void oracle_statement_backend::set_statement_attr(ub4 value, int attr)
+{
+    sword res = OCIAttrSet(stmtp_, OCI_HTYPE_STMT, &value, 0,
+        static_cast<ub4>(attr), session_.errhp_);
+    if (res != OCI_SUCCESS)
+    {
+        throw oracle_soci_error(res, session_.errhp_);
+    }
+}
+
 long long oracle_statement_backend::get_affected_rows()
 {
     return get_statement_attr<ub4>(OCI_ATTR_ROW_COUNT);
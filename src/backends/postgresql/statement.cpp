@@ -468,6 +468,8 @@ void postgresql_statement_backend::execute_bulk(int numberOfExecutions)
         }
 #endif
 
+        ++roundTrips_;
+
         // Now all the results must be read, up to and including the one
         // corresponding to the synchronization point itself.
         //
@@ -566,6 +568,8 @@ postgresql_statement_backend::execute(int number)
         throw soci_error("Bulk operations are not supported with single-row mode.");
     }
 
+    roundTrips_ = 0;
+
     // If the statement was "just described", then we know that
     // it was actually executed with all the use elements
     // already bound and pre-used. This means that the result of the
@@ -698,12 +702,17 @@ postgresql_statement_backend::execute(int number)
 
             current_row_ = -1;
 
+            roundTrips_ = 1;
+
             // otherwise (no bulk), follow the code below
         }
         else
         {
             // there are no use elements
             // - execute the query without parameter information
+
+            roundTrips_ = 1;
+
             if (stType_ == st_repeatable_query)
             {
                 // this query was separately prepared
@@ -800,8 +809,12 @@ postgresql_statement_backend::execute(int number)
         {
             if (number > 0)
             {
-                // prepare for the subsequent data consumption
-                return fetch(number);
+                // prepare for the subsequent data consumption, without
+                // forgetting about the round trip made above
+                int const roundTrips = roundTrips_;
+                exec_fetch_result const res = fetch(number);
+                roundTrips_ += roundTrips;
+                return res;
             }
             else
             {
@@ -825,6 +838,8 @@ postgresql_statement_backend::fetch(int number)
         throw soci_error("Bulk operations are not supported with single-row mode.");
     }
 
+    roundTrips_ = 0;
+
     if (numberOfRows_ == 0)
     {
         // There is nothing to fetch and normally we shouldn't be even called
@@ -849,6 +864,7 @@ postgresql_statement_backend::fetch(int number)
         {
             PGresult* res = PQgetResult(session_.conn_);
             result_.reset(res);
+            roundTrips_ = 1;
 
             if (res == nullptr)
             {
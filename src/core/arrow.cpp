@@ -0,0 +1,308 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/arrow.h"
+#include "soci/soci-unicode.h"
+
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "soci-mktime.h"
+
+using namespace soci;
+using namespace soci::details;
+
+namespace
+{
+
+// Data owned by an exported ArrowSchema.
+struct schema_data
+{
+    // Release the children, unless they were moved by the consumer.
+    ~schema_data()
+    {
+        for (ArrowSchema* child : children)
+        {
+            if (child->release)
+            {
+                child->release(child);
+            }
+        }
+    }
+
+    std::string format;
+    std::string name;
+
+    std::vector<std::unique_ptr<ArrowSchema>> childrenStorage;
+    std::vector<ArrowSchema*> children;
+};
+
+// Data owned by an exported ArrowArray.
+struct array_data
+{
+    ~array_data()
+    {
+        for (ArrowArray* child : children)
+        {
+            if (child->release)
+            {
+                child->release(child);
+            }
+        }
+    }
+
+    std::vector<std::vector<char>> buffersStorage;
+    std::vector<void const*> buffers;
+
+    std::vector<std::unique_ptr<ArrowArray>> childrenStorage;
+    std::vector<ArrowArray*> children;
+};
+
+extern "C" void release_schema(ArrowSchema* schema)
+{
+    delete static_cast<schema_data*>(schema->private_data);
+
+    schema->release = nullptr;
+}
+
+extern "C" void release_array(ArrowArray* array)
+{
+    delete static_cast<array_data*>(array->private_data);
+
+    array->release = nullptr;
+}
+
+void init_schema(ArrowSchema* schema, std::unique_ptr<schema_data> data,
+                 int64_t flags)
+{
+    schema->format = data->format.c_str();
+    schema->name = data->name.c_str();
+    schema->metadata = nullptr;
+    schema->flags = flags;
+    schema->n_children = static_cast<int64_t>(data->children.size());
+    schema->children = data->children.empty() ? nullptr : data->children.data();
+    schema->dictionary = nullptr;
+    schema->release = &release_schema;
+    schema->private_data = data.release();
+}
+
+void init_array(ArrowArray* array, std::unique_ptr<array_data> data,
+                std::size_t length, std::size_t nullCount)
+{
+    array->length = static_cast<int64_t>(length);
+    array->null_count = static_cast<int64_t>(nullCount);
+    array->offset = 0;
+    array->n_buffers = static_cast<int64_t>(data->buffers.size());
+    array->n_children = static_cast<int64_t>(data->children.size());
+    array->buffers = data->buffers.data();
+    array->children = data->children.empty() ? nullptr : data->children.data();
+    array->dictionary = nullptr;
+    array->release = &release_array;
+    array->private_data = data.release();
+}
+
+// Add a new buffer of the given size to the array data and return it.
+char* add_buffer(array_data& data, std::size_t size)
+{
+    // Don't use null pointers even for empty buffers, as some consumers may
+    // not expect them.
+    data.buffersStorage.emplace_back(size ? size : 1);
+    std::vector<char>& buf = data.buffersStorage.back();
+    data.buffers.push_back(buf.data());
+    return buf.data();
+}
+
+// Add the validity bitmap buffer, which is omitted if there are no nulls, and
+// return the number of nulls.
+std::size_t add_validity(array_data& data,
+                         std::vector<indicator> const& inds,
+                         std::size_t rows)
+{
+    std::size_t nullCount = 0;
+    for (std::size_t n = 0; n != rows; ++n)
+    {
+        if (inds[n] == i_null)
+        {
+            ++nullCount;
+        }
+    }
+
+    if (nullCount == 0)
+    {
+        data.buffers.push_back(nullptr);
+        return 0;
+    }
+
+    char* const bitmap = add_buffer(data, (rows + 7) / 8);
+    for (std::size_t n = 0; n != rows; ++n)
+    {
+        if (inds[n] != i_null)
+        {
+            bitmap[n / 8] |= static_cast<char>(1 << (n % 8));
+        }
+    }
+
+    return nullCount;
+}
+
+template <typename T>
+void add_fixed_width(array_data& data, std::vector<T> const& values, std::size_t rows)
+{
+    if (rows)
+    {
+        std::memcpy(add_buffer(data, rows * sizeof(T)), values.data(), rows * sizeof(T));
+    }
+    else
+    {
+        data.buffers.push_back(nullptr);
+    }
+}
+
+void add_strings(array_data& data, std::vector<std::string> const& values,
+                 std::vector<indicator> const& inds, std::size_t rows)
+{
+    std::size_t total = 0;
+    for (std::size_t n = 0; n != rows; ++n)
+    {
+        if (inds[n] != i_null)
+        {
+            total += values[n].size();
+        }
+    }
+
+    if (total > static_cast<std::size_t>(std::numeric_limits<int32_t>::max()))
+    {
+        throw soci_error("Strings data is too big to be exported to Arrow.");
+    }
+
+    int32_t* const offsets = reinterpret_cast<int32_t*>(
+                                add_buffer(data, (rows + 1) * sizeof(int32_t)));
+    char* const chars = add_buffer(data, total);
+
+    int32_t offset = 0;
+    for (std::size_t n = 0; n != rows; ++n)
+    {
+        offsets[n] = offset;
+        if (inds[n] != i_null)
+        {
+            std::string const& s = values[n];
+            std::memcpy(chars + offset, s.data(), s.size());
+            offset += static_cast<int32_t>(s.size());
+        }
+    }
+    offsets[rows] = offset;
+}
+
+// Fill the data for the given column and return the Arrow format string for it.
+char const* export_column(column_batch const& batch, std::size_t pos,
+                          array_data& data)
+{
+    std::size_t const rows = batch.get_number_of_rows();
+
+    if (batch.is_of_type<std::string>(pos))
+    {
+        add_strings(data, batch.get_column<std::string>(pos),
+                    batch.get_indicators(pos), rows);
+        return "u";
+    }
+
+    if (batch.is_of_type<std::wstring>(pos))
+    {
+        std::vector<std::wstring> const& values = batch.get_column<std::wstring>(pos);
+        std::vector<std::string> utf8(rows);
+        for (std::size_t n = 0; n != rows; ++n)
+        {
+            utf8[n] = wide_to_utf8(values[n]);
+        }
+
+        add_strings(data, utf8, batch.get_indicators(pos), rows);
+        return "u";
+    }
+
+    if (batch.is_of_type<std::tm>(pos))
+    {
+        std::vector<std::tm> const& values = batch.get_column<std::tm>(pos);
+        std::vector<int64_t> seconds(rows);
+        for (std::size_t n = 0; n != rows; ++n)
+        {
+            std::tm t = values[n];
+            seconds[n] = static_cast<int64_t>(timegm_impl(&t));
+        }
+
+        add_fixed_width(data, seconds, rows);
+        return "tss:";
+    }
+
+#define SOCI_ARROW_FIXED_WIDTH(type, format) \
+    if (batch.is_of_type<type>(pos)) \
+    { \
+        add_fixed_width(data, batch.get_column<type>(pos), rows); \
+        return format; \
+    }
+
+    SOCI_ARROW_FIXED_WIDTH(double, "g")
+    SOCI_ARROW_FIXED_WIDTH(int8_t, "c")
+    SOCI_ARROW_FIXED_WIDTH(uint8_t, "C")
+    SOCI_ARROW_FIXED_WIDTH(int16_t, "s")
+    SOCI_ARROW_FIXED_WIDTH(uint16_t, "S")
+    SOCI_ARROW_FIXED_WIDTH(int32_t, "i")
+    SOCI_ARROW_FIXED_WIDTH(uint32_t, "I")
+    SOCI_ARROW_FIXED_WIDTH(int64_t, "l")
+    SOCI_ARROW_FIXED_WIDTH(uint64_t, "L")
+
+#undef SOCI_ARROW_FIXED_WIDTH
+
+    throw soci_error("Column type not supported for Arrow export.");
+}
+
+} // anonymous namespace
+
+void soci::export_to_arrow(column_batch const& batch,
+                           ArrowSchema* schema,
+                           ArrowArray* array)
+{
+    std::size_t const rows = batch.get_number_of_rows();
+    std::size_t const columns = batch.get_number_of_columns();
+
+    std::unique_ptr<schema_data> schemaData(new schema_data);
+    schemaData->format = "+s";
+
+    std::unique_ptr<array_data> arrayData(new array_data);
+
+    // Struct arrays have only the validity buffer, which we don't need.
+    arrayData->buffers.push_back(nullptr);
+
+    // Note that the children are released when the parent data is deleted,
+    // so nothing leaks even if exporting one of the columns throws.
+    for (std::size_t pos = 0; pos != columns; ++pos)
+    {
+        std::unique_ptr<array_data> childArrayData(new array_data);
+        std::size_t const nullCount = add_validity(*childArrayData,
+                                                   batch.get_indicators(pos),
+                                                   rows);
+
+        std::unique_ptr<schema_data> childSchemaData(new schema_data);
+        childSchemaData->format = export_column(batch, pos, *childArrayData);
+        childSchemaData->name = batch.get_properties(pos).get_name();
+
+        schemaData->childrenStorage.emplace_back(new ArrowSchema);
+        ArrowSchema* const childSchema = schemaData->childrenStorage.back().get();
+        init_schema(childSchema, std::move(childSchemaData), ARROW_FLAG_NULLABLE);
+        schemaData->children.push_back(childSchema);
+
+        arrayData->childrenStorage.emplace_back(new ArrowArray);
+        ArrowArray* const childArray = arrayData->childrenStorage.back().get();
+        init_array(childArray, std::move(childArrayData), rows, nullCount);
+        arrayData->children.push_back(childArray);
+    }
+
+    init_schema(schema, std::move(schemaData), 0);
+    init_array(array, std::move(arrayData), rows, 0);
+}
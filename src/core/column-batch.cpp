@@ -0,0 +1,94 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/column-batch.h"
+
+#include <fmt/format.h>
+
+#include "soci-case.h"
+
+using namespace soci;
+using namespace details;
+
+column_batch::column_batch(std::size_t capacity)
+    : capacity_(capacity), rows_(0), uppercaseColumnNames_(false)
+{
+    if (capacity == 0)
+    {
+        throw soci_error("Column batch capacity must be positive.");
+    }
+}
+
+column_batch::~column_batch() = default;
+
+void column_batch::uppercase_column_names(bool forceToUpper)
+{
+    uppercaseColumnNames_ = forceToUpper;
+}
+
+void column_batch::clean_up()
+{
+    properties_.clear();
+    columns_.clear();
+    index_.clear();
+    rows_ = 0;
+}
+
+void column_batch::add_properties(column_properties const& cp)
+{
+    properties_.push_back(cp);
+
+    if (uppercaseColumnNames_)
+    {
+        properties_.back().set_name(string_toupper(cp.get_name()));
+    }
+
+    index_[properties_.back().get_name()] = properties_.size() - 1;
+}
+
+column_properties const& column_batch::get_properties(std::size_t pos) const
+{
+    return properties_.at(pos);
+}
+
+column_properties const& column_batch::get_properties(std::string const& name) const
+{
+    return get_properties(find_column(name));
+}
+
+std::vector<indicator> const& column_batch::get_indicators(std::size_t pos) const
+{
+    return columns_.at(pos)->indicators_;
+}
+
+std::vector<indicator> const& column_batch::get_indicators(std::string const& name) const
+{
+    return get_indicators(find_column(name));
+}
+
+void column_batch::resize_columns(std::size_t rows)
+{
+    if (rows > capacity_)
+    {
+        throw soci_error("Increasing the size of the output vector is not supported.");
+    }
+
+    for (auto const& column : columns_)
+    {
+        column->resize(rows);
+    }
+}
+
+std::size_t column_batch::find_column(std::string const& name) const
+{
+    auto const it = index_.find(name);
+    if (it == index_.end())
+    {
+        throw soci_error(fmt::format("Column '{}' not found", name));
+    }
+
+    return it->second;
+}
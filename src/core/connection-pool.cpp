@@ -8,17 +8,111 @@
 #include "soci/connection-pool.h"
 #include "soci/error.h"
 #include "soci/session.h"
+#include "soci/soci-backend.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <thread>
 #include <vector>
-#include <utility>
 
 #include "soci-mutex.h"
 
 using namespace soci;
 
-// Common base class for both POSIX and Windows implementations.
-struct soci_connection_pool_base_impl
+namespace
 {
-    explicit soci_connection_pool_base_impl(std::size_t size)
+
+std::size_t const bitsPerWord = 64;
+
+typedef std::chrono::steady_clock pool_clock;
+
+std::size_t const priorities = 3;
+
+// Thread waiting for a pool entry to become available.
+struct waiter
+{
+    soci_condition_t cond;
+    pool_clock::time_point deadline;
+
+    // Set when the deadline passes while waiting to let the waiters
+    // after this one proceed without waiting for it to wake up.
+    bool expired = false;
+};
+
+// Histogram with the buckets described in connection_pool_stats.
+class duration_histogram
+{
+public:
+    duration_histogram()
+    {
+        for (auto& b : buckets_)
+            b = 0;
+    }
+
+    void add(pool_clock::duration d)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+
+        std::size_t n = 0;
+        while (us > 0 && n != connection_pool_stats::histogram_buckets - 1)
+        {
+            us >>= 1;
+            ++n;
+        }
+
+        buckets_[n].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void get(connection_pool_stats::histogram& h) const
+    {
+        for (std::size_t n = 0; n != h.size(); ++n)
+            h[n] = buckets_[n].load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> buckets_[connection_pool_stats::histogram_buckets];
+};
+
+// Return the index of the lowest bit set in the given non-zero word.
+inline std::size_t lowest_bit_index(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t n = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+} // anonymous namespace
+
+// The pool keeps the free entries in a bitmap, which is updated using atomic
+// operations only, and the number of the free entries not reserved by any
+// thread yet in a separate counter. Leasing an entry consists in decrementing
+// this counter and then clearing a bit in the bitmap, which is guaranteed to
+// exist after a successful decrement, while giving it back sets the bit and
+// increments the counter, so that neither operation needs to lock anything
+// as long as there are free entries. The mutex is only used for waiting when
+// the pool is exhausted, or when other threads are already waiting, as they
+// must be served in the order of their priorities.
+//
+// The pools created with connection_parameters open their sessions on demand
+// and the entries with smaller indices are always preferred for them, so that
+// the sessions with the bigger ones remain unused, and can be closed by
+// maintain(), when the pool is not fully used.
+struct connection_pool::connection_pool_impl
+{
+    explicit connection_pool_impl(std::size_t size)
+        : words_((size + bitsPerWord - 1) / bitsPerWord),
+          available_(static_cast<std::ptrdiff_t>(size))
     {
         if (size == 0)
         {
@@ -28,209 +122,678 @@ struct soci_connection_pool_base_impl
         sessions_.resize(size);
         for (std::size_t i = 0; i != size; ++i)
         {
-            sessions_[i] = std::make_pair(true, std::make_unique<session>());
+            sessions_[i].sql = std::make_unique<session>();
+        }
+
+        // Initially all entries are free.
+        freeMask_.reset(new std::atomic<std::uint64_t>[words_]);
+        for (std::size_t w = 0; w != words_; ++w)
+        {
+            std::size_t const bits = w + 1 < words_ ? bitsPerWord
+                                                    : size - w * bitsPerWord;
+            freeMask_[w] = bits == bitsPerWord ? ~std::uint64_t(0)
+                                               : (std::uint64_t(1) << bits) - 1;
         }
     }
 
-    ~soci_connection_pool_base_impl() = default;
+    connection_pool_impl(connection_pool_impl const&) = delete;
+    connection_pool_impl& operator=(connection_pool_impl const&) = delete;
 
-    bool find_free(std::size_t & pos)
+    ~connection_pool_impl()
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        if (maintainer_.joinable())
         {
-            if (sessions_[i].first)
             {
-                pos = i;
-                return true;
+                soci_scoped_lock lock(&maintainerMtx_);
+                stopping_ = true;
+                maintainerCond_.notify_one();
             }
-        }
 
-        return false;
+            maintainer_.join();
+        }
     }
 
+    // Must be called before marking the entry as free, as the session must
+    // not be used by another thread yet when the backend hook is executed.
+    // Returns the duration of the lease.
+    pool_clock::duration notify_give_back(std::size_t pos)
+    {
+        entry & e = sessions_[pos];
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, std::unique_ptr<session>> > sessions_;
-};
+        e.sql->unbind_prepared_statements();
 
-#ifndef _WIN32
-// POSIX implementation
+        details::session_backend * const backEnd = e.sql->get_backend();
+        if (backEnd)
+        {
+            backEnd->on_pool_give_back();
+        }
 
-#include <pthread.h>
-#include <sys/time.h>
-#include <errno.h>
+        e.lastUsed = pool_clock::now();
+        update_open_state(e, backEnd != nullptr);
 
-struct connection_pool::connection_pool_impl : soci_connection_pool_base_impl
-{
-    explicit connection_pool_impl(std::size_t size)
-        : soci_connection_pool_base_impl(size)
+        return e.lastUsed - e.leasedAt;
+    }
+
+    // Update the statistics after successfully leasing the given entry.
+    void on_leased(std::size_t pos, pool_clock::time_point start)
     {
-        if (pthread_cond_init(&cond_, nullptr) != 0)
+        pool_clock::time_point const now = pool_clock::now();
+
+        sessions_[pos].leasedAt = now;
+        waitTime_.add(now - start);
+
+        leases_.fetch_add(1, std::memory_order_relaxed);
+
+        std::size_t const inUse = ++inUse_;
+        std::size_t hwm = highWaterMark_.load(std::memory_order_relaxed);
+        while (inUse > hwm &&
+                !highWaterMark_.compare_exchange_weak(hwm, inUse,
+                    std::memory_order_relaxed))
         {
-            throw soci_error("Synchronization error");
         }
     }
 
-    connection_pool_impl(connection_pool_impl const&) = delete;
-    connection_pool_impl& operator=(connection_pool_impl const&) = delete;
+    // Return the number of free entries which must be left available after
+    // reserving an entry for a request with the given priority.
+    std::ptrdiff_t get_reserved_above(lease_priority priority) const
+    {
+        std::ptrdiff_t reserved = 0;
+        for (std::size_t n = static_cast<std::size_t>(priority) + 1; n < priorities; ++n)
+        {
+            reserved += reserved_[n].load(std::memory_order_relaxed);
+        }
 
-    ~connection_pool_impl()
+        return reserved;
+    }
+
+    // Reserve one of the free entries, if there are any more than the given
+    // number, without blocking.
+    bool try_reserve(std::ptrdiff_t keep = 0)
     {
-        pthread_cond_destroy(&cond_);
+        std::ptrdiff_t n = available_.load();
+        while (n > keep)
+        {
+            if (available_.compare_exchange_weak(n, n - 1))
+            {
+                return true;
+            }
+        }
+
+        return false;
     }
 
-    soci_mutex_t mtx_;
-    pthread_cond_t cond_;
-};
+    // Find a free entry and mark it as used: this can only be called after a
+    // successful try_reserve(), guaranteeing that there is such an entry.
+    std::size_t claim()
+    {
+        // Start looking from different words in different threads to avoid
+        // all of them competing for the same one, unless we prefer to reuse
+        // the entries with the smallest indices.
+        std::size_t const start = parameters_
+                                    ? 0
+                                    : nextWord_.fetch_add(1, std::memory_order_relaxed);
+
+        for (;;)
+        {
+            for (std::size_t i = 0; i != words_; ++i)
+            {
+                std::size_t const w = (start + i) % words_;
+
+                std::uint64_t bits = freeMask_[w].load(std::memory_order_relaxed);
+                while (bits != 0)
+                {
+                    std::uint64_t const bit = bits & (~bits + 1);
+                    if (freeMask_[w].compare_exchange_weak(bits, bits & ~bit,
+                            std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return w * bitsPerWord + lowest_bit_index(bit);
+                    }
+                }
+            }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
-{
-    struct timespec tm;
-    if (timeout >= 0)
+            // Other threads may have claimed the entries we've seen as free
+            // before we could do it, but our reservation guarantees that
+            // there is still at least one free entry left, so just retry.
+        }
+    }
+
+    // Reserve a free entry for a request with the given priority, waiting
+    // for it until the deadline. Waiting requests are kept in a queue for
+    // each priority and only the first one of the highest priority queue
+    // can take the next available entry.
+    bool wait_and_reserve(lease_priority priority, pool_clock::time_point deadline)
     {
-        // timeout is relative in milliseconds
+        bool const infinite = deadline == pool_clock::time_point::max();
+        std::ptrdiff_t const keep = get_reserved_above(priority);
+        std::deque<waiter*> & queue = queues_[static_cast<std::size_t>(priority)];
+
+        soci_scoped_lock lock(&mtx_);
+
+        // Note that this must be done before checking for the available
+        // entries, see unreserve().
+        waiter self;
+        self.deadline = deadline;
+        queue.push_back(&self);
+        ++waiters_;
+
+        bool reserved = false;
+        bool failed = false;
+        for (;;)
+        {
+            if (!self.expired && is_first(&self) && try_reserve(keep))
+            {
+                reserved = true;
+                break;
+            }
+
+            int remaining = -1;
+            if (!infinite)
+            {
+                auto const left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    deadline - pool_clock::now()).count();
+                if (self.expired || left <= 0)
+                {
+                    break;
+                }
+
+                // Round up to avoid busy waiting during the last millisecond.
+                // For very distant deadlines, just wait as long as possible:
+                // we'll wait again after waking up if it's still not reached.
+                remaining = static_cast<int>(
+                    std::min<decltype(left)>(left, INT_MAX - 1)) + 1;
+            }
 
-        struct timeval tmv;
-        gettimeofday(&tmv, nullptr);
+            if (!self.cond.wait(mtx_, remaining) && infinite)
+            {
+                failed = true;
+                break;
+            }
+        }
 
-        tm.tv_sec = tmv.tv_sec + timeout / 1000;
-        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+        queue.erase(std::find(queue.begin(), queue.end(), &self));
+        --waiters_;
 
-        if (tm.tv_nsec >= 1000 * 1000 * 1000)
+        // Let the next waiter have the entry which could be still available.
+        wake_next();
+
+        if (failed)
         {
-            ++tm.tv_sec;
-            tm.tv_nsec -= 1000 * 1000 * 1000;
+            throw soci_error("Getting connection from the pool unexpectedly failed");
         }
-    }
 
-    soci_scoped_lock lock(&pimpl_->mtx_);
+        return reserved;
+    }
 
-    int cc = 0;
-    while (pimpl_->find_free(pos) == false)
+    // Check if this waiter is the next one to be served. Must be called with
+    // the mutex locked.
+    bool is_first(waiter const * w) const
     {
-        if (timeout < 0)
+        for (std::size_t n = priorities; n-- > 0; )
         {
-            // no timeout, allow unlimited blocking
-            cc = pthread_cond_wait(
-                &(pimpl_->cond_), pimpl_->mtx_.native_handle());
+            for (waiter const * other : queues_[n])
+            {
+                if (!other->expired)
+                {
+                    return other == w;
+                }
+            }
         }
-        else
+
+        return false;
+    }
+
+    // Wake up the next waiter to be served, if any, after dropping all the
+    // waiters whose deadline has passed. Must be called with the mutex locked.
+    void wake_next()
+    {
+        pool_clock::time_point const now = pool_clock::now();
+        for (std::size_t n = priorities; n-- > 0; )
         {
-            // wait with timeout
-            cc = pthread_cond_timedwait(
-                &(pimpl_->cond_), pimpl_->mtx_.native_handle(), &tm);
+            for (waiter * w : queues_[n])
+            {
+                if (w->expired)
+                {
+                    continue;
+                }
+
+                if (w->deadline <= now)
+                {
+                    w->expired = true;
+                    w->cond.notify_one();
+                    continue;
+                }
+
+                w->cond.notify_one();
+                return;
+            }
         }
+    }
 
-        if (cc == ETIMEDOUT)
+    // Mark the given entry as used if it is currently free.
+    bool try_claim(std::size_t pos)
+    {
+        if (!try_reserve())
         {
-            break;
+            return false;
         }
 
-        // pthread_cond_timedwait() can apparently return these errors too,
-        // even if POSIX doesn't document them for the scenario in which we
-        // call it.
-        if (cc == EINVAL || cc == EPERM)
+        std::atomic<std::uint64_t> & word = freeMask_[pos / bitsPerWord];
+        std::uint64_t const bit = std::uint64_t(1) << (pos % bitsPerWord);
+        std::uint64_t bits = word.load(std::memory_order_relaxed);
+        while (bits & bit)
         {
-            // We should perhaps throw an exception here, but at the very least
-            // exit the loop to avoid being stuck in it forever.
-            break;
+            if (word.compare_exchange_weak(bits, bits & ~bit,
+                    std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
         }
+
+        // The entry is not free, so we must release our reservation.
+        unreserve();
+
+        return false;
     }
 
-    if (cc == 0)
+    bool is_free(std::size_t pos) const
     {
-        pimpl_->sessions_[pos].first = false;
+        std::uint64_t const bit = std::uint64_t(1) << (pos % bitsPerWord);
+        return (freeMask_[pos / bitsPerWord].load(std::memory_order_relaxed) & bit) != 0;
     }
 
-    if (cc != 0)
+    void release(std::size_t pos)
     {
-        // we can only fail if timeout expired
-        if (timeout < 0)
+        std::uint64_t const bit = std::uint64_t(1) << (pos % bitsPerWord);
+        if (freeMask_[pos / bitsPerWord].fetch_or(bit, std::memory_order_release) & bit)
         {
-            throw soci_error("Getting connection from the pool unexpectedly failed");
+            throw soci_error("Cannot release pool entry (already free)");
         }
 
-        return false;
+        unreserve();
     }
 
-    return true;
-}
+    void unreserve()
+    {
+        ++available_;
 
-void connection_pool::give_back(std::size_t pos)
-{
-    if (pos >= pimpl_->sessions_.size())
+        // Both this check and the one in wait_and_reserve() are sequentially
+        // consistent, so either the waiter sees the entry we've just made
+        // available or we see it and must wake it up. In the latter case,
+        // locking the mutex ensures that it is already waiting.
+        if (waiters_ != 0)
+        {
+            soci_scoped_lock lock(&mtx_);
+            wake_next();
+        }
+    }
+
+    // Open the session of the entry, which must be claimed by the caller,
+    // if it isn't open yet or if it was closed or lost its connection.
+    void prepare_for_use(std::size_t pos)
     {
-        throw soci_error("Invalid pool position");
+        entry & e = sessions_[pos];
+
+        try
+        {
+            if (e.isOpen &&
+                    options_.validation_interval.count() > 0 &&
+                    pool_clock::now() - e.lastUsed > options_.validation_interval &&
+                    !e.sql->is_connected())
+            {
+                close_entry(e);
+            }
+
+            if (!e.sql->get_backend())
+            {
+                update_open_state(e, false);
+
+                open_entry(e);
+            }
+        }
+        catch (...)
+        {
+            release(pos);
+            throw;
+        }
     }
 
-    soci_scoped_lock lock(&pimpl_->mtx_);
+    void maintain()
+    {
+        if (!parameters_)
+        {
+            throw soci_error("Only pools opening sessions themselves can be maintained");
+        }
+
+        // The sessions could have been closed since they were given back to
+        // the pool, make sure we take this into account.
+        for (std::size_t pos = 0; pos != sessions_.size(); ++pos)
+        {
+            if (try_claim(pos))
+            {
+                entry & e = sessions_[pos];
+                update_open_state(e, e.sql->get_backend() != nullptr);
+
+                release(pos);
+            }
+        }
+
+        // Close the idle sessions first, starting with the ones with the
+        // biggest indices, which are used least often.
+        if (options_.idle_timeout.count() > 0)
+        {
+            pool_clock::time_point const now = pool_clock::now();
+            for (std::size_t pos = sessions_.size(); pos-- > 0; )
+            {
+                if (openCount_ <= options_.min_size)
+                {
+                    break;
+                }
+
+                if (!try_claim(pos))
+                {
+                    continue;
+                }
+
+                entry & e = sessions_[pos];
+                if (e.isOpen && now - e.lastUsed > options_.idle_timeout)
+                {
+                    close_entry(e);
+                }
+
+                release(pos);
+            }
+        }
+
+        // Then open the new ones, if necessary.
+        for (std::size_t pos = 0; pos != sessions_.size(); ++pos)
+        {
+            if (openCount_ >= options_.min_size)
+            {
+                break;
+            }
+
+            if (!try_claim(pos))
+            {
+                continue;
+            }
 
-    if (pimpl_->sessions_[pos].first)
+            entry & e = sessions_[pos];
+            if (!e.isOpen)
+            {
+                try
+                {
+                    open_entry(e);
+                }
+                catch (...)
+                {
+                    release(pos);
+                    throw;
+                }
+            }
+
+            release(pos);
+        }
+    }
+
+    void start_maintainer()
     {
-        throw soci_error("Cannot release pool entry (already free)");
+        maintainer_ = std::thread([this]() {
+            for (;;)
+            {
+                // Errors are ignored here, as there is nobody to report them
+                // to, and we'll just retry the next time.
+                try
+                {
+                    maintain();
+                }
+                catch (...)
+                {
+                }
+
+                soci_scoped_lock lock(&maintainerMtx_);
+                if (!stopping_)
+                {
+                    maintainerCond_.wait(maintainerMtx_,
+                        static_cast<int>(options_.maintenance_interval.count()));
+                }
+
+                if (stopping_)
+                {
+                    break;
+                }
+            }
+        });
     }
 
-    pimpl_->sessions_[pos].first = true;
+    struct entry
+    {
+        std::unique_ptr<session> sql;
 
-    pthread_cond_signal(&(pimpl_->cond_));
-}
+        // The fields below can only be accessed by the thread leasing the
+        // entry and, except for leasedAt, are only used by the pools opening
+        // the sessions themselves.
 
-#else
-// Windows implementation
+        // Last time the session was given back to the pool (or opened).
+        pool_clock::time_point lastUsed;
 
-#include <windows.h>
+        // Time when the entry was leased, used for statistics only.
+        pool_clock::time_point leasedAt;
 
-struct connection_pool::connection_pool_impl : soci_connection_pool_base_impl
-{
-    explicit connection_pool_impl(std::size_t size)
-        : soci_connection_pool_base_impl(size)
+        // Whether the session is counted in openCount_.
+        bool isOpen = false;
+    };
+
+    void update_open_state(entry & e, bool isOpen)
     {
-        // initially all entries are available
-        sem_ = CreateSemaphore(nullptr,
-            static_cast<LONG>(size), static_cast<LONG>(size), nullptr);
-        if (sem_ == nullptr)
+        if (isOpen != e.isOpen)
         {
-            throw soci_error("Synchronization error");
+            e.isOpen = isOpen;
+            if (isOpen)
+                ++openCount_;
+            else
+                --openCount_;
         }
     }
 
-    ~connection_pool_impl()
+    // Open the session of the entry and prepare it for use.
+    void open_entry(entry & e)
     {
-        CloseHandle(sem_);
+        e.sql->open(*parameters_);
+
+        try
+        {
+            if (options_.warm_up)
+            {
+                options_.warm_up(*e.sql);
+            }
+
+            if (!options_.prepared_statements.empty() &&
+                    !e.sql->get_backend()->supports_pool_prepared_statements())
+            {
+                throw soci_error("Option prepared_statements of connection_pool "
+                                 "can't be used with the sessions of \""
+                                 + e.sql->get_backend_name() + "\" backend "
+                                 "opened with these parameters.");
+            }
+
+            for (auto const & kv : options_.prepared_statements)
+            {
+                e.sql->add_prepared_statement(kv.first, kv.second);
+            }
+        }
+        catch (...)
+        {
+            // Don't leave the session half-initialized, it will be reopened
+            // when it's needed the next time.
+            e.sql->close();
+            throw;
+        }
+
+        e.lastUsed = pool_clock::now();
+        update_open_state(e, true);
+    }
+
+    void close_entry(entry & e)
+    {
+        update_open_state(e, false);
+
+        try
+        {
+            e.sql->close();
+        }
+        catch (...)
+        {
+            // The session is unusable anyhow, so just ignore it.
+        }
     }
 
+    std::vector<entry> sessions_;
+
+    // Bitmap of the free entries, with the bit set if the entry is free.
+    std::size_t const words_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> freeMask_;
+
+    // Number of free entries not reserved by any thread yet.
+    std::atomic<std::ptrdiff_t> available_;
+
+    // Index of the word to start looking for a free entry from.
+    std::atomic<std::size_t> nextWord_{0};
+
+    // Number of threads waiting for an entry to become available.
+    std::atomic<int> waiters_{0};
+
+    // Queues of the waiting threads for each priority, protected by mtx_.
     soci_mutex_t mtx_;
-    HANDLE sem_;
+    std::deque<waiter*> queues_[priorities];
+
+    // Number of entries reserved for each priority.
+    std::atomic<std::ptrdiff_t> reserved_[priorities] = {};
+
+    // Only set for the pools opening the sessions themselves.
+    std::unique_ptr<connection_parameters> parameters_;
+    connection_pool_options options_;
+
+    // Number of open sessions, only maintained if parameters_ is set.
+    std::atomic<std::size_t> openCount_{0};
+
+    // Statistics.
+    std::atomic<std::size_t> inUse_{0};
+    std::atomic<std::size_t> highWaterMark_{0};
+    std::atomic<std::uint64_t> leases_{0};
+    std::atomic<std::uint64_t> timeouts_{0};
+    duration_histogram waitTime_;
+    duration_histogram holdTime_;
+
+    // Background thread calling maintain() periodically, if any.
+    std::thread maintainer_;
+    soci_mutex_t maintainerMtx_;
+    soci_condition_t maintainerCond_;
+    bool stopping_ = false;
 };
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
+connection_pool::connection_pool(std::size_t size)
+               : pimpl_(std::make_unique<connection_pool_impl>(size))
+{
+}
+
+connection_pool::connection_pool(connection_parameters const & parameters,
+                                 connection_pool_options const & options)
+               : pimpl_(std::make_unique<connection_pool_impl>(options.max_size))
 {
-    DWORD cc = WaitForSingleObject(pimpl_->sem_,
-        timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE);
-    if (cc == WAIT_OBJECT_0)
+    if (options.min_size > options.max_size)
     {
-        // semaphore acquired, there is (at least) one free entry
+        throw soci_error("Minimal pool size can't be greater than the maximal one");
+    }
 
-        soci_scoped_lock lock(&pimpl_->mtx_);
+    pimpl_->parameters_ = std::make_unique<connection_parameters>(parameters);
+    pimpl_->options_ = options;
 
-        if (!pimpl_->find_free(pos))
+    if (options.collect_statistics)
+    {
+        for (auto & e : pimpl_->sessions_)
         {
-            // this should be impossible
-            throw soci_error("Getting connection from the pool unexpectedly failed");
+            e.sql->collect_statistics(true);
         }
+    }
 
-        pimpl_->sessions_[pos].first = false;
+    if (options.maintenance_interval.count() > 0)
+    {
+        pimpl_->start_maintainer();
+    }
+}
 
-        return true;
+connection_pool::~connection_pool() = default;
+
+std::size_t connection_pool::size() const
+{
+    return pimpl_->sessions_.size();
+}
+
+std::size_t connection_pool::in_use() const
+{
+    return pimpl_->inUse_.load(std::memory_order_relaxed);
+}
+
+session & connection_pool::at(std::size_t pos)
+{
+    if (pos >= pimpl_->sessions_.size())
+    {
+        throw soci_error("Invalid pool position");
     }
-    else if (cc == WAIT_TIMEOUT)
+
+    return *(pimpl_->sessions_[pos].sql);
+}
+
+std::size_t connection_pool::lease()
+{
+    return lease(lease_priority::normal);
+}
+
+bool connection_pool::try_lease(std::size_t & pos, int timeout)
+{
+    return try_lease(pos, lease_priority::normal,
+                     timeout < 0
+                        ? pool_clock::time_point::max()
+                        : pool_clock::now() + std::chrono::milliseconds(timeout));
+}
+
+std::size_t connection_pool::lease(lease_priority priority)
+{
+    std::size_t pos SOCI_DUMMY_INIT(0);
+
+    // no timeout, so can't fail
+    try_lease(pos, priority, pool_clock::time_point::max());
+
+    return pos;
+}
+
+bool connection_pool::try_lease(std::size_t & pos, lease_priority priority,
+                                std::chrono::steady_clock::time_point deadline)
+{
+    pool_clock::time_point const start = pool_clock::now();
+
+    // Only block if there are no free entries or if somebody else is already
+    // waiting for them, but never wait if the caller doesn't need the entry
+    // any longer anyhow.
+    std::ptrdiff_t const keep = pimpl_->get_reserved_above(priority);
+    bool const reserved = pimpl_->waiters_ == 0 && pimpl_->try_reserve(keep);
+    if (!reserved && (deadline <= start ||
+                        !pimpl_->wait_and_reserve(priority, deadline)))
     {
+        pimpl_->timeouts_.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
-    else
+
+    pos = pimpl_->claim();
+
+    if (pimpl_->parameters_)
     {
-        throw soci_error("Synchronization error");
+        pimpl_->prepare_for_use(pos);
     }
+
+    pimpl_->on_leased(pos, start);
+
+    return true;
 }
 
 void connection_pool::give_back(std::size_t pos)
@@ -240,45 +803,63 @@ void connection_pool::give_back(std::size_t pos)
         throw soci_error("Invalid pool position");
     }
 
-    soci_scoped_lock lock(&pimpl_->mtx_);
-
-    if (pimpl_->sessions_[pos].first)
+    if (pimpl_->is_free(pos))
     {
         throw soci_error("Cannot release pool entry (already free)");
     }
 
-    pimpl_->sessions_[pos].first = true;
-
-    ReleaseSemaphore(pimpl_->sem_, 1, nullptr);
-}
-
-#endif // _WIN32
+    pimpl_->holdTime_.add(pimpl_->notify_give_back(pos));
+    --pimpl_->inUse_;
 
-connection_pool::connection_pool(std::size_t size)
-               : pimpl_(std::make_unique<connection_pool_impl>(size))
-{
+    pimpl_->release(pos);
 }
 
-connection_pool::~connection_pool() = default;
-
-session & connection_pool::at(std::size_t pos)
+void connection_pool::set_reserved_capacity(lease_priority priority,
+                                            std::size_t count)
 {
-    if (pos >= pimpl_->sessions_.size())
+    std::size_t const n = static_cast<std::size_t>(priority);
+    if (n >= priorities)
     {
-        throw soci_error("Invalid pool position");
+        throw soci_error("Invalid lease priority");
     }
 
-    return *(pimpl_->sessions_[pos].second);
+    pimpl_->reserved_[n] = static_cast<std::ptrdiff_t>(count);
 }
 
-std::size_t connection_pool::lease()
+void connection_pool::maintain()
 {
-    std::size_t pos SOCI_DUMMY_INIT(0);
-
-    // no timeout, so can't fail
-    try_lease(pos, -1);
+    pimpl_->maintain();
+}
 
-    return pos;
+connection_pool_stats connection_pool::get_stats() const
+{
+    connection_pool_stats stats;
+
+    stats.size = pimpl_->sessions_.size();
+    stats.in_use = pimpl_->inUse_.load(std::memory_order_relaxed);
+    stats.free = stats.in_use < stats.size ? stats.size - stats.in_use : 0;
+    stats.high_water_mark = pimpl_->highWaterMark_.load(std::memory_order_relaxed);
+    stats.leases = pimpl_->leases_.load(std::memory_order_relaxed);
+    stats.timeouts = pimpl_->timeouts_.load(std::memory_order_relaxed);
+    pimpl_->waitTime_.get(stats.wait_time);
+    pimpl_->holdTime_.get(stats.hold_time);
+
+    return stats;
 }
 
+session_statistics connection_pool::get_statistics(std::size_t topQueries) const
+{
+    session_statistics stats;
+
+    // Note that this doesn't need any locking, as the sessions objects are
+    // never destroyed before the pool itself and their statistics can be
+    // retrieved even while they're used by other threads.
+    for (auto const & e : pimpl_->sessions_)
+    {
+        stats += e.sql->get_statistics(static_cast<std::size_t>(-1));
+    }
 
+    stats.keep_top_queries(topQueries);
+
+    return stats;
+}
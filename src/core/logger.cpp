@@ -37,6 +37,19 @@ void logger_impl::clear_query_parameters()
     queryParams_.clear();
 }
 
+bool logger_impl::wants_query_end() const
+{
+    return false;
+}
+
+void logger_impl::end_execute(std::string const &, query_end_info const &)
+{
+}
+
+void logger_impl::end_fetch(std::string const &, query_end_info const &)
+{
+}
+
 logger_impl * logger_impl::clone() const
 {
     logger_impl * const impl = do_clone();
@@ -96,10 +109,13 @@ logger::logger(logger_impl * impl)
     {
         throw soci_error("Null logger implementation not allowed.");
     }
+
+    m_wantsQueryEnd = m_impl->wants_query_end();
 }
 
 logger::logger(logger const & other)
-    : m_impl(other.m_impl->clone())
+    : m_impl(other.m_impl->clone()),
+      m_wantsQueryEnd(other.m_wantsQueryEnd)
 {
 }
 
@@ -107,6 +123,7 @@ logger& logger::operator=(logger const & other)
 {
     logger_impl * const implOld = m_impl;
     m_impl = other.m_impl->clone();
+    m_wantsQueryEnd = other.m_wantsQueryEnd;
     delete implOld;
 
     return *this;
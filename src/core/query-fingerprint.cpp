@@ -0,0 +1,407 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/query-fingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace soci;
+
+namespace // anonymous
+{
+
+// Note that we don't use the standard functions from <cctype> here because
+// they depend on the current locale and are slower.
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Return true for the characters which can start an identifier, including
+// all non-ASCII ones.
+inline bool is_ident_start(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+            static_cast<unsigned char>(c) >= 0x80;
+}
+
+inline bool is_ident_char(char c)
+{
+    return is_ident_start(c) || is_digit(c) || c == '$';
+}
+
+char const * skip_spaces(char const * p, char const * end)
+{
+    while (p != end && is_space(*p))
+        ++p;
+
+    return p;
+}
+
+inline bool is_number_start(char const * p, char const * end)
+{
+    if (p == end)
+        return false;
+
+    if (is_digit(*p))
+        return true;
+
+    return *p == '.' && p + 1 != end && is_digit(p[1]);
+}
+
+// Return true if the space between the tokens ending and starting with the
+// given characters must be preserved, i.e. if they would merge without it.
+inline bool needs_space(char last, char first)
+{
+    auto const is_word_char = [](char c)
+    {
+        return is_ident_char(c) || c == '?' || c == '@' ||
+                c == '\'' || c == '"' || c == '`' || c == '[' || c == ']';
+    };
+
+    if (is_word_char(last) && is_word_char(first))
+        return true;
+
+    // Also avoid creating comment delimiters.
+    return (last == '-' && first == '-') ||
+            (last == '/' && first == '*') ||
+            (last == '*' && first == '/');
+}
+
+// Return true if the given identifier is one of the keywords which can be
+// followed by a number with a unary sign.
+bool is_keyword_before_operand(char const * start, char const * end)
+{
+    static char const * const keywords[] =
+    {
+        "and", "as", "between", "by", "case", "else", "having", "in", "is",
+        "like", "limit", "not", "offset", "on", "or", "return", "select",
+        "set", "then", "values", "when", "where",
+    };
+
+    std::size_t const len = static_cast<std::size_t>(end - start);
+    for (char const * kw : keywords)
+    {
+        if (std::strlen(kw) != len)
+            continue;
+
+        std::size_t n = 0;
+        for (; n != len; ++n)
+        {
+            char c = start[n];
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+
+            if (c != kw[n])
+                break;
+        }
+
+        if (n == len)
+            return true;
+    }
+
+    return false;
+}
+
+// Return the pointer after the end of the quoted string or identifier
+// starting at the given position, which must contain the opening quote.
+char const * skip_quoted(char const * p, char const * end,
+                         char closing, bool backslashEscapes)
+{
+    for (++p; p != end; ++p)
+    {
+        if (backslashEscapes && *p == '\\')
+        {
+            if (++p == end)
+                break;
+        }
+        else if (*p == closing)
+        {
+            // Doubled closing quote is an escaped quote character.
+            if (p + 1 == end || p[1] != closing)
+                return p + 1;
+
+            ++p;
+        }
+    }
+
+    return end;
+}
+
+// Return the pointer after the end of the number starting at the given
+// position.
+char const * skip_number(char const * p, char const * end)
+{
+    bool const hex = p + 1 != end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+
+    for (++p; p != end; ++p)
+    {
+        char const c = *p;
+        if (is_ident_char(c) || c == '.')
+            continue;
+
+        // Sign of the exponent.
+        if (!hex && (c == '+' || c == '-') && (p[-1] == 'e' || p[-1] == 'E'))
+            continue;
+
+        break;
+    }
+
+    return p;
+}
+
+} // namespace anonymous
+
+query_fingerprint::query_fingerprint(std::string const & query,
+                                     database_engine engine)
+    : size_(0), hash_(offset_basis)
+{
+    bool const isMySQL = engine == database_engine::mysql;
+    bool const isPostgreSQL = engine == database_engine::postgresql;
+    bool const bracketIdentifiers = engine == database_engine::mssql ||
+                                    engine == database_engine::sqlite3;
+    bool const backtickIdentifiers = isMySQL ||
+                                     engine == database_engine::sqlite3;
+
+    // Only the innermost parenthesized list is tracked: this is the size and
+    // the hash just after its opening parenthesis or npos if there is no list
+    // or it contains anything but literals, separated by commas.
+    std::size_t const npos = static_cast<std::size_t>(-1);
+    std::size_t listStart = npos;
+    std::uint64_t listHash = 0;
+    bool listHasLiterals = false;
+
+    // The last character appended before the current token, if any.
+    char last = '\0';
+
+    // True if the last token was an operand, i.e. an identifier, a literal, a
+    // placeholder or a closing parenthesis, and so a sign following it is a
+    // binary operator and not a part of a number.
+    bool afterOperand = false;
+
+    char const * p = query.c_str();
+    char const * const end = p + query.size();
+    while (p != end)
+    {
+        char const c = *p;
+        char const next = p + 1 != end ? p[1] : '\0';
+
+        // Whitespace and comments only separate the tokens, we insert a
+        // single space between them only if it's really needed below.
+        if (is_space(c))
+        {
+            ++p;
+            continue;
+        }
+
+        if ((c == '-' && next == '-') || (c == '#' && isMySQL))
+        {
+            while (p != end && *p != '\n')
+                ++p;
+
+            continue;
+        }
+
+        if (c == '/' && next == '*')
+        {
+            for (p += 2; p != end; ++p)
+            {
+                if (*p == '*' && p + 1 != end && p[1] == '/')
+                {
+                    p += 2;
+                    break;
+                }
+            }
+
+            continue;
+        }
+
+        char const * const start = p;
+        bool literal = false;
+        bool operand = true;
+
+        if (c == '\'' || (c == '"' && isMySQL))
+        {
+            p = skip_quoted(p, end, c, isMySQL);
+            literal = true;
+        }
+        else if (c == '"' || (c == '`' && backtickIdentifiers) ||
+                    (c == '[' && bracketIdentifiers))
+        {
+            p = skip_quoted(p, end, c == '[' ? ']' : c, false);
+        }
+        else if (c == '$' && isPostgreSQL && !is_digit(next))
+        {
+            // This is either a dollar-quoted string, with the optional tag
+            // between the dollar signs, or just a "$" which we copy as is.
+            char const * tagEnd = p + 1;
+            while (tagEnd != end && is_ident_char(*tagEnd) && *tagEnd != '$')
+                ++tagEnd;
+
+            if (tagEnd != end && *tagEnd == '$')
+            {
+                ++tagEnd;
+                p = std::search(tagEnd, end, p, tagEnd);
+                if (p != end)
+                    p += tagEnd - start;
+                literal = true;
+            }
+            else
+            {
+                ++p;
+            }
+        }
+        else if (is_digit(c) || (c == '.' && is_digit(next)))
+        {
+            p = skip_number(p, end);
+            literal = true;
+        }
+        else if ((c == '-' || c == '+') && !afterOperand &&
+                    is_number_start(skip_spaces(p + 1, end), end))
+        {
+            // Unary sign is part of the number, so that negative values
+            // result in the same fingerprint as the positive ones.
+            p = skip_number(skip_spaces(p + 1, end), end);
+            literal = true;
+        }
+        else if (is_ident_start(c))
+        {
+            while (p != end && is_ident_char(*p))
+                ++p;
+
+            operand = !is_keyword_before_operand(start, p);
+
+            // Check for the prefixed string literals such as N'...' or E'...'.
+            if (p - start == 1 && p != end && *p == '\'')
+            {
+                switch (c)
+                {
+                    case 'B': case 'b':
+                    case 'E': case 'e':
+                    case 'N': case 'n':
+                    case 'X': case 'x':
+                        p = skip_quoted(p, end, '\'',
+                                        isMySQL || c == 'E' || c == 'e');
+                        literal = true;
+                        break;
+
+                    default:
+                        // Just a single letter identifier.
+                        break;
+                }
+            }
+        }
+        else if (c == '$' && isPostgreSQL)
+        {
+            // Positional placeholder.
+            for (++p; p != end && is_digit(*p); ++p)
+                ;
+        }
+        else
+        {
+            ++p;
+
+            // Only closing parenthesis and positional placeholders used by
+            // ODBC are operands among the other characters.
+            operand = c == ')' || c == '?';
+        }
+
+        afterOperand = operand;
+
+        if (size_ != 0 && needs_space(last, literal ? '?' : c))
+            append(' ');
+
+        if (literal)
+        {
+            append('?');
+            last = '?';
+
+            if (listStart != npos)
+                listHasLiterals = true;
+
+            continue;
+        }
+
+        switch (c)
+        {
+            case '(':
+                append('(');
+                listStart = size_;
+                listHash = hash_;
+                listHasLiterals = false;
+                break;
+
+            case ')':
+                if (listStart != npos && listHasLiterals)
+                {
+                    truncate(listStart, listHash);
+                    append("...)");
+                }
+                else
+                {
+                    append(')');
+                }
+
+                listStart = npos;
+                break;
+
+            case ',':
+                append(',');
+                break;
+
+            default:
+                for (char const * q = start; q != p; ++q)
+                    append(*q);
+
+                listStart = npos;
+        }
+
+        last = p[-1];
+    }
+}
+
+void query_fingerprint::append(char c)
+{
+    if (size_ < inline_size)
+    {
+        inline_[size_] = c;
+    }
+    else
+    {
+        if (size_ == inline_size)
+            long_.assign(inline_, inline_size);
+
+        long_ += c;
+    }
+
+    ++size_;
+
+    hash_ ^= static_cast<unsigned char>(c);
+    hash_ *= prime;
+}
+
+void query_fingerprint::append(char const * s)
+{
+    while (*s)
+        append(*s++);
+}
+
+void query_fingerprint::truncate(std::size_t size, std::uint64_t hash)
+{
+    if (size > inline_size)
+        long_.resize(size);
+    else
+        long_.clear();
+
+    size_ = size;
+    hash_ = hash;
+}
@@ -0,0 +1,217 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/routing-pool.h"
+#include "soci/error.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+using namespace soci;
+
+namespace
+{
+
+typedef std::chrono::steady_clock pool_clock;
+
+} // anonymous namespace
+
+struct routing_pool::routing_pool_impl
+{
+    routing_pool_impl(connection_parameters const & primary,
+                      std::vector<connection_parameters> const & replicas,
+                      routing_pool_options const & options)
+        : primary_(primary, options.pool),
+          options_(options),
+          ejectedUntil_(new std::atomic<pool_clock::rep>[replicas.size()])
+    {
+        replicas_.reserve(replicas.size());
+        for (std::size_t n = 0; n != replicas.size(); ++n)
+        {
+            replicas_.push_back(std::make_unique<connection_pool>(replicas[n],
+                                                                  options.pool));
+            ejectedUntil_[n] = pool_clock::time_point::min().time_since_epoch().count();
+        }
+    }
+
+    bool is_ejected(std::size_t n, pool_clock::time_point now) const
+    {
+        return now.time_since_epoch().count() < ejectedUntil_[n].load(std::memory_order_relaxed);
+    }
+
+    void eject(std::size_t n)
+    {
+        pool_clock::time_point const until = pool_clock::now() + options_.ejection_time;
+        ejectedUntil_[n].store(until.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Fill the vector with the number of leased sessions and the index of
+    // the replicas which are not ejected, in the order of increasing load.
+    void get_candidates(std::vector<std::pair<std::size_t, std::size_t>> & candidates) const
+    {
+        pool_clock::time_point const now = pool_clock::now();
+
+        candidates.clear();
+        for (std::size_t n = 0; n != replicas_.size(); ++n)
+        {
+            if (!is_ejected(n, now))
+            {
+                candidates.emplace_back(replicas_[n]->in_use(), n);
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+            [](std::pair<std::size_t, std::size_t> const & a,
+               std::pair<std::size_t, std::size_t> const & b)
+            {
+                return a.first < b.first;
+            });
+    }
+
+    connection_pool & lease_for_read(std::size_t & pos)
+    {
+        int const waitInterval = static_cast<int>(options_.wait_interval.count());
+
+        std::vector<std::pair<std::size_t, std::size_t>> candidates;
+        candidates.reserve(replicas_.size());
+        for (;;)
+        {
+            get_candidates(candidates);
+
+            // Prefer to use any replica which has a free session right now,
+            // while removing the ones which failed from the candidates.
+            std::size_t usable = 0;
+            for (std::size_t i = 0; i != candidates.size(); ++i)
+            {
+                std::size_t const n = candidates[i].second;
+                try
+                {
+                    if (replicas_[n]->try_lease(pos, 0))
+                    {
+                        return *replicas_[n];
+                    }
+
+                    candidates[usable++] = candidates[i];
+                }
+                catch (soci_error const &)
+                {
+                    // Opening the session failed, don't try to use this
+                    // replica again for some time.
+                    eject(n);
+                }
+            }
+
+            candidates.resize(usable);
+
+            if (candidates.empty())
+            {
+                if (!options_.read_from_primary)
+                {
+                    throw soci_error("No replica is available for reading "
+                                     "and reading from the primary is disabled.");
+                }
+
+                // Don't wait indefinitely here either, as the replicas may
+                // stop being ejected in the meanwhile.
+                if (primary_.try_lease(pos, waitInterval))
+                {
+                    return primary_;
+                }
+
+                continue;
+            }
+
+            if (options_.read_from_primary && primary_.try_lease(pos, 0))
+            {
+                return primary_;
+            }
+
+            // All replicas are busy, wait for the least loaded one, but only
+            // for a limited time as another replica or the primary could
+            // become free sooner.
+            std::size_t const n = candidates.front().second;
+            try
+            {
+                if (replicas_[n]->try_lease(pos, waitInterval))
+                {
+                    return *replicas_[n];
+                }
+            }
+            catch (soci_error const &)
+            {
+                eject(n);
+            }
+        }
+    }
+
+    connection_pool primary_;
+    std::vector<std::unique_ptr<connection_pool>> replicas_;
+    routing_pool_options const options_;
+
+    // Time until which each replica is ejected, as the number of ticks since
+    // the clock epoch.
+    std::unique_ptr<std::atomic<pool_clock::rep>[]> ejectedUntil_;
+};
+
+routing_pool::routing_pool(connection_parameters const & primary,
+                           std::vector<connection_parameters> const & replicas,
+                           routing_pool_options const & options)
+    : pimpl_(std::make_unique<routing_pool_impl>(primary, replicas, options))
+{
+}
+
+routing_pool::~routing_pool() = default;
+
+connection_pool & routing_pool::primary()
+{
+    return pimpl_->primary_;
+}
+
+std::size_t routing_pool::replicas_count() const
+{
+    return pimpl_->replicas_.size();
+}
+
+connection_pool & routing_pool::replica(std::size_t n)
+{
+    if (n >= pimpl_->replicas_.size())
+    {
+        throw soci_error("Invalid replica index");
+    }
+
+    return *pimpl_->replicas_[n];
+}
+
+connection_pool & routing_pool::lease(access_intent intent, std::size_t & pos)
+{
+    if (intent == access_intent::write)
+    {
+        pos = pimpl_->primary_.lease();
+        return pimpl_->primary_;
+    }
+
+    return pimpl_->lease_for_read(pos);
+}
+
+void routing_pool::eject_replica(std::size_t n)
+{
+    if (n >= pimpl_->replicas_.size())
+    {
+        throw soci_error("Invalid replica index");
+    }
+
+    pimpl_->eject(n);
+}
+
+bool routing_pool::is_replica_ejected(std::size_t n) const
+{
+    if (n >= pimpl_->replicas_.size())
+    {
+        throw soci_error("Invalid replica index");
+    }
+
+    return pimpl_->is_ejected(n, pool_clock::now());
+}
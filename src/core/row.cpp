@@ -6,10 +6,14 @@
 //
 
 #include "soci/row.h"
+#include "soci/statement.h"
 #include "soci/type-holder.h"
 
 #include <cstddef>
+#include <ctime>
+#include <functional>
 #include <string>
+#include <utility>
 #include <fmt/format.h>
 
 #include "soci-case.h"
@@ -18,10 +22,44 @@ using namespace soci;
 using namespace details;
 
 row::row()
-    : uppercaseColumnNames_(false)
+    : shape_(0)
+    , storageUsed_(0)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
+    , lazyStatement_(nullptr)
 {}
 
+row::row(row &&other)
+    : row()
+{
+    *this = std::move(other);
+}
+
+row &row::operator=(row &&other)
+{
+    if (this != &other)
+    {
+        clean_up();
+
+        // The moved row can't be used by the statement any longer, so get
+        // all its values from it first.
+        other.detach_lazy_statement();
+
+        columns_ = std::exchange(other.columns_, {});
+        holders_ = std::exchange(other.holders_, {});
+        indicators_ = std::exchange(other.indicators_, {});
+        index_ = std::exchange(other.index_, {});
+        shape_ = std::exchange(other.shape_, 0);
+        storage_ = std::exchange(other.storage_, {});
+        storageUsed_ = std::exchange(other.storageUsed_, 0);
+        lazyStates_ = std::exchange(other.lazyStates_, {});
+        uppercaseColumnNames_ = other.uppercaseColumnNames_;
+        currentPos_ = other.currentPos_;
+    }
+
+    return *this;
+}
+
 row::~row()
 {
     clean_up();
@@ -52,7 +90,115 @@ void row::add_properties(column_properties const &cp)
         columnName = originalName;
     }
 
-    index_[columnName] = columns_.size() - 1;
+    std::size_t const h = std::hash<std::string>()(columnName) +
+                            static_cast<std::size_t>(cp.get_db_type());
+    shape_ ^= h + 0x9e3779b9 + (shape_ << 6) + (shape_ >> 2);
+
+    // Keep the load factor under 1/2 to ensure that the lookups are fast.
+    if (columns_.size() * 2 > index_.size())
+    {
+        index_.assign(index_.empty() ? 16 : index_.size() * 2, 0);
+
+        std::size_t const csize = columns_.size();
+        for (std::size_t i = 0; i != csize; ++i)
+        {
+            add_to_index(i);
+        }
+    }
+    else
+    {
+        add_to_index(columns_.size() - 1);
+    }
+}
+
+void row::add_to_index(std::size_t pos)
+{
+    std::string const& name = columns_[pos].get_name();
+    std::size_t const mask = index_.size() - 1;
+    for (std::size_t i = std::hash<std::string>()(name) & mask;; i = (i + 1) & mask)
+    {
+        // If there are several columns with the same name, the last one
+        // is found when looking it up by name.
+        if (index_[i] == 0 || columns_[index_[i] - 1].get_name() == name)
+        {
+            index_[i] = pos + 1;
+            return;
+        }
+    }
+}
+
+namespace
+{
+
+template <typename T>
+void add_storage_size(std::size_t& size)
+{
+    size = (size + alignof(T) - 1) / alignof(T) * alignof(T) + sizeof(T);
+}
+
+} // anonymous namespace
+
+void row::reserve_holders(std::vector<db_type> const& types)
+{
+    // Compute the size needed for storing all the values in exactly the
+    // same way as add_holder() will allocate them.
+    std::size_t size = 0;
+    for (db_type type : types)
+    {
+        switch (type)
+        {
+        case db_string:
+        case db_xml:
+            add_storage_size<std::string>(size);
+            break;
+        case db_wstring:
+            add_storage_size<std::wstring>(size);
+            break;
+        case db_blob:
+            add_storage_size<blob>(size);
+            break;
+        case db_double:
+            add_storage_size<double>(size);
+            break;
+        case db_int8:
+            add_storage_size<int8_t>(size);
+            break;
+        case db_uint8:
+            add_storage_size<uint8_t>(size);
+            break;
+        case db_int16:
+            add_storage_size<int16_t>(size);
+            break;
+        case db_uint16:
+            add_storage_size<uint16_t>(size);
+            break;
+        case db_int32:
+            add_storage_size<int32_t>(size);
+            break;
+        case db_uint32:
+            add_storage_size<uint32_t>(size);
+            break;
+        case db_int64:
+            add_storage_size<int64_t>(size);
+            break;
+        case db_uint64:
+            add_storage_size<uint64_t>(size);
+            break;
+        case db_date:
+            add_storage_size<std::tm>(size);
+            break;
+        }
+    }
+
+    // Reuse the existing buffer if it's big enough.
+    std::size_t const units = (size + sizeof(storage_unit) - 1) / sizeof(storage_unit);
+    if (units > storage_.size())
+    {
+        storage_.resize(units);
+    }
+
+    holders_.reserve(types.size());
+    indicators_.reserve(types.size());
 }
 
 std::size_t row::size() const
@@ -62,22 +208,90 @@ std::size_t row::size() const
 
 void row::clean_up()
 {
+    if (lazyStatement_)
+    {
+        lazyStatement_->detach_lazy_row();
+        lazyStatement_ = nullptr;
+    }
+
+    // Note that the storage itself is kept to be reused later.
     std::size_t const hsize = holders_.size();
     for (std::size_t i = 0; i != hsize; ++i)
     {
-        delete holders_[i];
-        delete indicators_[i];
+        holders_[i].destroy();
     }
+    storageUsed_ = 0;
 
     columns_.clear();
     holders_.clear();
     indicators_.clear();
     index_.clear();
+    shape_ = 0;
+    lazyStates_.clear();
+}
+
+void row::set_lazy_statement(statement_impl* st)
+{
+    lazyStatement_ = st;
+    lazyStates_.assign(holders_.size(), lazy_column_loaded);
+}
+
+void row::reset_lazy_columns(bool gotData)
+{
+    // If no data was fetched, there is nothing to retrieve and the values
+    // are left unchanged, as for the non-lazy rows.
+    lazyStates_.assign(holders_.size(),
+                       gotData ? lazy_column_pending : lazy_column_loaded);
+}
+
+void row::detach_lazy_statement()
+{
+    if (!lazyStatement_)
+    {
+        return;
+    }
+
+    // This is called when the statement is cleaned up, so retrieve all the
+    // values not accessed yet while it is still possible. We can't throw
+    // here, so remember the columns whose values couldn't be retrieved to
+    // throw when they're accessed instead.
+    std::size_t const lsize = lazyStates_.size();
+    for (std::size_t i = 0; i != lsize; ++i)
+    {
+        if (lazyStates_[i] == lazy_column_pending)
+        {
+            try
+            {
+                lazyStatement_->load_row_column(i);
+                lazyStates_[i] = lazy_column_loaded;
+            }
+            catch (...)
+            {
+                lazyStates_[i] = lazy_column_unavailable;
+            }
+        }
+    }
+
+    lazyStatement_->detach_lazy_row();
+    lazyStatement_ = nullptr;
+}
+
+void row::do_load(std::size_t pos) const
+{
+    if (lazyStates_[pos] == lazy_column_unavailable || !lazyStatement_)
+    {
+        throw soci_error(fmt::format("Value of the column {} could not be retrieved",
+                                     pos + 1));
+    }
+
+    lazyStatement_->load_row_column(pos);
+    lazyStates_[pos] = lazy_column_loaded;
 }
 
 indicator row::get_indicator(std::size_t pos) const
 {
-    return *indicators_.at(pos);
+    load(pos);
+    return indicators_.at(pos);
 }
 
 indicator row::get_indicator(std::string const &name) const
@@ -97,23 +311,32 @@ column_properties const & row::get_properties(std::string const &name) const
 
 std::size_t row::find_column(std::string const &name) const
 {
-    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-    if (it == index_.end())
+    if (!index_.empty())
     {
-        throw soci_error(fmt::format("Column '{}' not found", name));
+        std::size_t const mask = index_.size() - 1;
+        for (std::size_t i = std::hash<std::string>()(name) & mask;
+             index_[i] != 0;
+             i = (i + 1) & mask)
+        {
+            if (columns_[index_[i] - 1].get_name() == name)
+            {
+                return index_[i] - 1;
+            }
+        }
     }
 
-    return it->second;
+    throw soci_error(fmt::format("Column '{}' not found", name));
 }
 
 template <>
 blob row::move_as<blob>(std::size_t pos) const
 {
     typedef typename type_conversion<blob>::base_type base_type;
-    base_type & baseVal = holders_.at(pos)->get<base_type>(value_reference_tag{});
+    load(pos);
+    base_type & baseVal = holders_.at(pos).get<base_type>(value_reference_tag{});
 
     blob ret;
-    type_conversion<blob>::move_from_base(baseVal, *indicators_.at(pos), ret);
+    type_conversion<blob>::move_from_base(baseVal, indicators_.at(pos), ret);
 
     // Re-initialize blob object so it can be used in further queries
     baseVal.initialize(ret.get_backend()->get_session_backend().make_blob_backend());
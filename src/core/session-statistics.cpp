@@ -0,0 +1,199 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/session-statistics.h"
+#include "soci-statistics.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+void add_query_statistics(query_statistics & to, query_statistics const & from)
+{
+    to.executions += from.executions;
+    to.errors += from.errors;
+    to.rows += from.rows;
+    to.total_time += from.total_time;
+}
+
+} // namespace anonymous
+
+session_statistics &
+session_statistics::operator+=(session_statistics const & other)
+{
+    statements_prepared += other.statements_prepared;
+    statements_executed += other.statements_executed;
+    cache_hits += other.cache_hits;
+    rows_fetched += other.rows_fetched;
+    rows_affected += other.rows_affected;
+    backend_time += other.backend_time;
+    conversion_time += other.conversion_time;
+    exceptions += other.exceptions;
+
+    std::unordered_map<std::uint64_t, std::size_t> indices;
+    for (std::size_t n = 0; n != top_queries.size(); ++n)
+    {
+        indices.emplace(top_queries[n].hash, n);
+    }
+
+    for (query_statistics const & q : other.top_queries)
+    {
+        auto const it = indices.find(q.hash);
+        if (it != indices.end())
+        {
+            add_query_statistics(top_queries[it->second], q);
+        }
+        else
+        {
+            top_queries.push_back(q);
+        }
+    }
+
+    // Keep the queries sorted, but don't remove any of them, as the caller
+    // may be going to add more statistics to these ones.
+    keep_top_queries(top_queries.size());
+
+    return *this;
+}
+
+void session_statistics::keep_top_queries(std::size_t count)
+{
+    std::stable_sort(top_queries.begin(), top_queries.end(),
+        [](query_statistics const & a, query_statistics const & b)
+        {
+            return a.total_time > b.total_time;
+        });
+
+    if (top_queries.size() > count)
+    {
+        top_queries.resize(count);
+    }
+}
+
+void statistics_collector::add_prepare()
+{
+    soci_scoped_lock lock(&mutex_);
+
+    ++totals_.statements_prepared;
+}
+
+void statistics_collector::add_cache_hit()
+{
+    soci_scoped_lock lock(&mutex_);
+
+    ++totals_.cache_hits;
+}
+
+void statistics_collector::add_exception()
+{
+    soci_scoped_lock lock(&mutex_);
+
+    ++totals_.exceptions;
+}
+
+void statistics_collector::add_execute(query_end_info const & info,
+                                       std::chrono::steady_clock::duration backendTime)
+{
+    soci_scoped_lock lock(&mutex_);
+
+    ++totals_.statements_executed;
+    if (info.affectedRows > 0)
+    {
+        totals_.rows_affected += static_cast<std::uint64_t>(info.affectedRows);
+    }
+
+    do_add(info, backendTime, true);
+}
+
+void statistics_collector::add_fetch(query_end_info const & info,
+                                     std::chrono::steady_clock::duration backendTime)
+{
+    soci_scoped_lock lock(&mutex_);
+
+    do_add(info, backendTime, false);
+}
+
+void statistics_collector::do_add(query_end_info const & info,
+                                  std::chrono::steady_clock::duration backendTime,
+                                  bool isExecute)
+{
+    using std::chrono::nanoseconds;
+    using std::chrono::duration_cast;
+
+    nanoseconds const total = duration_cast<nanoseconds>(info.duration);
+    nanoseconds const backend = duration_cast<nanoseconds>(backendTime);
+
+    totals_.rows_fetched += info.fetchedRows;
+    totals_.backend_time += backend;
+    totals_.conversion_time += total > backend ? total - backend : nanoseconds(0);
+
+    query_fingerprint const & fingerprint = *info.fingerprint;
+
+    auto it = queries_.find(fingerprint.hash());
+    if (it == queries_.end())
+    {
+        if (queries_.size() == max_queries)
+        {
+            return;
+        }
+
+        it = queries_.emplace(fingerprint.hash(), query_statistics()).first;
+        it->second.query = fingerprint.str();
+        it->second.hash = fingerprint.hash();
+    }
+
+    query_statistics & q = it->second;
+    if (isExecute)
+    {
+        ++q.executions;
+    }
+    if (info.failed)
+    {
+        ++q.errors;
+    }
+
+    q.rows += info.fetchedRows;
+    if (info.affectedRows > 0)
+    {
+        q.rows += static_cast<std::uint64_t>(info.affectedRows);
+    }
+
+    q.total_time += total;
+}
+
+session_statistics statistics_collector::get(std::size_t topQueries) const
+{
+    session_statistics stats;
+
+    {
+        soci_scoped_lock lock(&mutex_);
+
+        stats = totals_;
+
+        stats.top_queries.reserve(queries_.size());
+        for (auto const & kv : queries_)
+        {
+            stats.top_queries.push_back(kv.second);
+        }
+    }
+
+    stats.keep_top_queries(topQueries);
+
+    return stats;
+}
+
+void statistics_collector::reset()
+{
+    soci_scoped_lock lock(&mutex_);
+
+    totals_ = session_statistics();
+    queries_.clear();
+}
@@ -8,9 +8,12 @@
 #include "soci/session.h"
 #include "soci/connection-parameters.h"
 #include "soci/connection-pool.h"
+#include "soci/routing-pool.h"
 #include "soci/soci-backend.h"
+#include "soci/statement.h"
 #include "soci/query_transformation.h"
 #include "soci/log-context.h"
+#include "soci-statistics.h"
 
 #include <fmt/format.h>
 
@@ -83,14 +86,16 @@ private:
 
 session::session()
     : once(this), prepare(this),
-      logger_(new standard_logger_impl)
+      logger_(new standard_logger_impl),
+      statistics_(std::make_unique<statistics_collector>())
 {
 }
 
 session::session(connection_parameters const & parameters)
     : once(this), prepare(this),
       logger_(new standard_logger_impl),
-      lastConnectParameters_(parameters)
+      lastConnectParameters_(parameters),
+      statistics_(std::make_unique<statistics_collector>())
 {
     open(lastConnectParameters_);
 }
@@ -99,7 +104,8 @@ session::session(backend_factory const & factory,
     std::string const & connectString)
     : once(this), prepare(this),
       logger_(new standard_logger_impl),
-      lastConnectParameters_(factory, connectString)
+      lastConnectParameters_(factory, connectString),
+      statistics_(std::make_unique<statistics_collector>())
 {
     open(lastConnectParameters_);
 }
@@ -108,7 +114,8 @@ session::session(std::string const & backendName,
     std::string const & connectString)
     : once(this), prepare(this),
       logger_(new standard_logger_impl),
-      lastConnectParameters_(backendName, connectString)
+      lastConnectParameters_(backendName, connectString),
+      statistics_(std::make_unique<statistics_collector>())
 {
     open(lastConnectParameters_);
 }
@@ -116,7 +123,8 @@ session::session(std::string const & backendName,
 session::session(std::string const & connectString)
     : once(this), prepare(this),
       logger_(new standard_logger_impl),
-      lastConnectParameters_(connectString)
+      lastConnectParameters_(connectString),
+      statistics_(std::make_unique<statistics_collector>())
 {
     open(lastConnectParameters_);
 }
@@ -133,14 +141,32 @@ session::session(connection_pool & pool)
     backEnd_ = pooledSession.get_backend();
 }
 
+session::session(routing_pool & pool, access_intent intent)
+    : logger_(new standard_logger_impl),
+      isFromPool_(true)
+{
+    pool_ = &pool.lease(intent, poolPosition_);
+    session & pooledSession = pool_->at(poolPosition_);
+
+    once.set_session(&pooledSession);
+    prepare.set_session(&pooledSession);
+    backEnd_ = pooledSession.get_backend();
+}
+
 session::session(session && other)
     : once(std::move(other.once)),
       prepare(std::move(other.prepare)),
       query_stream_(std::move(other.query_stream_)),
       query_transformation_(std::move(other.query_transformation_)),
       logger_(std::move(other.logger_)),
+      deferredParamsNames_(std::move(other.deferredParamsNames_)),
+      deferredParamsValues_(std::move(other.deferredParamsValues_)),
+      hasCustomLogger_(std::move(other.hasCustomLogger_)),
       lastConnectParameters_(std::move(other.lastConnectParameters_)),
       uppercaseColumnNames_(std::move(other.uppercaseColumnNames_)),
+      lazyRowConversion_(std::move(other.lazyRowConversion_)),
+      statistics_(std::move(other.statistics_)),
+      collectStatistics_(std::move(other.collectStatistics_)),
       backEnd_(std::move(other.backEnd_)),
       gotData_(std::move(other.gotData_)),
       isFromPool_(std::move(other.isFromPool_)),
@@ -163,6 +189,8 @@ session& session::operator=(session && other)
 {
     if (this != &other)
     {
+        preparedStatements_.clear();
+
         if (isFromPool_)
         {
             pool_->give_back(poolPosition_);
@@ -184,8 +212,15 @@ session& session::operator=(session && other)
         query_stream_ = std::move(other.query_stream_);
         query_transformation_ = std::move(other.query_transformation_);
         logger_ = std::move(other.logger_);
+        hasCustomLogger_ = std::move(other.hasCustomLogger_);
         lastConnectParameters_ = std::move(other.lastConnectParameters_);
         uppercaseColumnNames_ = std::move(other.uppercaseColumnNames_);
+        lazyRowConversion_ = std::move(other.lazyRowConversion_);
+        statistics_ = std::move(other.statistics_);
+        collectStatistics_ = std::move(other.collectStatistics_);
+        deferredParamsStatement_ = nullptr;
+        deferredParamsNames_ = std::move(other.deferredParamsNames_);
+        deferredParamsValues_ = std::move(other.deferredParamsValues_);
         backEnd_ = std::move(other.backEnd_);
         gotData_ = std::move(other.gotData_);
         isFromPool_ = std::move(other.isFromPool_);
@@ -200,6 +235,13 @@ session& session::operator=(session && other)
 
 void session::reset_after_move()
 {
+    // The statements still refer to this object, so they can't be moved.
+    preparedStatements_.clear();
+
+    deferredParamsStatement_ = nullptr;
+    deferredParamsNames_.clear();
+    deferredParamsValues_.clear();
+    collectStatistics_ = false;
     backEnd_ = nullptr;
     gotData_ = false;
     isFromPool_ = false;
@@ -244,6 +286,7 @@ session::~session()
         }
         else
         {
+            preparedStatements_.clear();
             delete backEnd_;
         }
     }
@@ -300,6 +343,8 @@ void session::open(std::string const & connectString)
 
 void session::close()
 {
+    preparedStatements_.clear();
+
     auto* const backEnd = backEnd_;
     backEnd_ = nullptr;
 
@@ -434,7 +479,11 @@ void session::set_logger(logger const & logger)
     }
     else
     {
+        deferredParamsStatement_ = nullptr;
+        deferredParamsNames_.clear();
+        deferredParamsValues_.clear();
         logger_ = logger;
+        hasCustomLogger_ = true;
     }
 }
 
@@ -492,6 +541,9 @@ void session::log_query(std::string const & query)
     }
     else
     {
+        deferredParamsStatement_ = nullptr;
+        deferredParamsNames_.clear();
+        deferredParamsValues_.clear();
         logger_.start_query(query);
     }
 }
@@ -504,6 +556,9 @@ void session::clear_query_parameters()
     }
     else
     {
+        deferredParamsStatement_ = nullptr;
+        deferredParamsNames_.clear();
+        deferredParamsValues_.clear();
         logger_.clear_query_parameters();
     }
 }
@@ -520,6 +575,137 @@ void session::add_query_parameter(std::string name, std::string value)
     }
 }
 
+bool session::defer_query_parameters(details::statement_impl * st)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).defer_query_parameters(st);
+    }
+
+    // Custom loggers may use the parameters of every query, so they must be
+    // added to them for each execution.
+    if (hasCustomLogger_)
+    {
+        return false;
+    }
+
+    deferredParamsStatement_ = st;
+
+    return true;
+}
+
+void session::add_deferred_query_parameters(details::statement_impl * st)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).add_deferred_query_parameters(st);
+    }
+    else if (deferredParamsStatement_ != nullptr && deferredParamsStatement_ == st)
+    {
+        deferredParamsStatement_ = nullptr;
+
+        // Just take the parameters, they're only formatted if the query
+        // context is really needed.
+        st->release_query_parameters(deferredParamsNames_, deferredParamsValues_);
+    }
+}
+
+void session::format_deferred_query_parameters()
+{
+    if (deferredParamsStatement_ != nullptr)
+    {
+        add_deferred_query_parameters(deferredParamsStatement_);
+    }
+
+    if (deferredParamsNames_.empty())
+    {
+        return;
+    }
+
+    std::ostringstream value;
+
+    std::size_t const count = deferredParamsNames_.size();
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        value.str(std::string());
+        deferredParamsValues_[i].dump(value);
+        logger_.add_query_parameter(std::move(deferredParamsNames_[i]),
+                                    value.str());
+    }
+
+    deferredParamsNames_.clear();
+    deferredParamsValues_.clear();
+}
+
+void session::add_prepared_statement(std::string const & key,
+                                     std::string const & query)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).add_prepared_statement(key, query);
+        return;
+    }
+
+    std::unique_ptr<statement> st(new statement(*this));
+    st->alloc();
+    st->prepare(query);
+
+    preparedStatements_[key] = std::move(st);
+}
+
+bool session::has_prepared_statement(std::string const & key) const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).has_prepared_statement(key);
+    }
+
+    return preparedStatements_.find(key) != preparedStatements_.end();
+}
+
+statement & session::get_prepared_statement(std::string const & key)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_prepared_statement(key);
+    }
+
+    auto const it = preparedStatements_.find(key);
+    if (it == preparedStatements_.end())
+    {
+        throw soci_error(fmt::format("No prepared statement with key \"{}\".", key));
+    }
+
+    if (collectStatistics_)
+    {
+        statistics_->add_cache_hit();
+    }
+
+    return *it->second;
+}
+
+void session::unbind_prepared_statements()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).unbind_prepared_statements();
+        return;
+    }
+
+    for (auto const & kv : preparedStatements_)
+    {
+        try
+        {
+            kv.second->bind_clean_up();
+        }
+        catch (...)
+        {
+            // This is called when giving back the session, possibly from
+            // session destructor, so we can't let the exceptions escape.
+        }
+    }
+}
+
 std::string session::get_last_query() const
 {
     if (isFromPool_)
@@ -540,6 +726,11 @@ std::string session::get_last_query_context() const
     }
     else
     {
+        // The parameters are only added to the logger when they're needed,
+        // which is now, so do it even though this function is logically
+        // const.
+        const_cast<session*>(this)->format_deferred_query_parameters();
+
         return logger_.get_last_query_context();
     }
 }
@@ -592,6 +783,98 @@ bool session::get_uppercase_column_names() const
     }
 }
 
+void session::lazy_row_conversion(bool lazy)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).lazy_row_conversion(lazy);
+    }
+    else
+    {
+        lazyRowConversion_ = lazy;
+    }
+}
+
+bool session::get_lazy_row_conversion() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_lazy_row_conversion();
+    }
+    else
+    {
+        return lazyRowConversion_;
+    }
+}
+
+void session::collect_statistics(bool collect)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).collect_statistics(collect);
+    }
+    else
+    {
+        // The collector is allocated when the session is created, as it may
+        // be accessed by connection_pool::get_statistics() from another
+        // thread, and is only missing if this session was moved from.
+        if (collect && !statistics_)
+        {
+            statistics_ = std::make_unique<statistics_collector>();
+        }
+
+        collectStatistics_ = collect;
+    }
+}
+
+bool session::get_collect_statistics() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_collect_statistics();
+    }
+    else
+    {
+        return collectStatistics_;
+    }
+}
+
+session_statistics session::get_statistics(std::size_t topQueries) const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statistics(topQueries);
+    }
+    else
+    {
+        return statistics_ ? statistics_->get(topQueries) : session_statistics();
+    }
+}
+
+void session::reset_statistics()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).reset_statistics();
+    }
+    else if (statistics_)
+    {
+        statistics_->reset();
+    }
+}
+
+statistics_collector * session::get_statistics_collector()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statistics_collector();
+    }
+    else
+    {
+        return collectStatistics_ ? statistics_.get() : nullptr;
+    }
+}
+
 bool session::get_next_sequence_value(std::string const & sequence, long long & value)
 {
     ensureConnected(backEnd_);
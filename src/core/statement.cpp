@@ -14,7 +14,9 @@
 #include "soci/values.h"
 #include "soci-compiler.h"
 #include "soci-ssize.h"
+#include "soci-statistics.h"
 #include "soci/log-context.h"
+#include <algorithm>
 #include <ctime>
 #include <cctype>
 #include <cstdint>
@@ -26,6 +28,186 @@ using namespace soci;
 using namespace soci::details;
 
 
+namespace // anonymous
+{
+
+// Adds the time elapsed during its lifetime to the given duration, if any.
+class backend_call_timer
+{
+public:
+    explicit backend_call_timer(std::chrono::steady_clock::duration * total)
+        : total_(total)
+    {
+        if (total_)
+        {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~backend_call_timer()
+    {
+        if (total_)
+        {
+            *total_ += std::chrono::steady_clock::now() - start_;
+        }
+    }
+
+    backend_call_timer(backend_call_timer const &) = delete;
+    backend_call_timer& operator=(backend_call_timer const &) = delete;
+
+private:
+    std::chrono::steady_clock::duration * const total_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+bool is_numeric(db_type dbtype)
+{
+    switch (dbtype)
+    {
+        case db_int8:
+        case db_uint8:
+        case db_int16:
+        case db_uint16:
+        case db_int32:
+        case db_uint32:
+        case db_int64:
+        case db_uint64:
+        case db_double:
+            return true;
+
+        case db_string:
+        case db_wstring:
+        case db_date:
+        case db_blob:
+        case db_xml:
+            break;
+    }
+
+    return false;
+}
+
+// Return the name of the kind of values of the given type, used in the error
+// messages only.
+char const * get_type_kind(db_type dbtype)
+{
+    switch (dbtype)
+    {
+        case db_string:
+        case db_wstring:
+            return "string";
+
+        case db_int8:
+        case db_uint8:
+        case db_int16:
+        case db_uint16:
+        case db_int32:
+        case db_uint32:
+        case db_int64:
+        case db_uint64:
+        case db_double:
+            return "numeric";
+
+        case db_date:
+            return "date";
+
+        case db_blob:
+            return "BLOB";
+
+        case db_xml:
+            return "XML";
+    }
+
+    return "unknown";
+}
+
+char const * get_type_kind(exchange_type type)
+{
+    switch (type)
+    {
+        case x_char:
+        case x_stdstring:
+        case x_stdwstring:
+        case x_longstring:
+            return "string";
+
+        case x_int8:
+        case x_uint8:
+        case x_int16:
+        case x_uint16:
+        case x_int32:
+        case x_uint32:
+        case x_int64:
+        case x_uint64:
+        case x_double:
+            return "numeric";
+
+        case x_stdtm:
+            return "date";
+
+        case x_blob:
+            return "BLOB";
+
+        case x_xmltype:
+            return "XML";
+
+        case x_statement:
+        case x_rowid:
+            break;
+    }
+
+    return "unknown";
+}
+
+// Check if the column of the given type can be fetched into the given type.
+//
+// This is deliberately lenient, as the types reported by the backends are not
+// always precise, and only rejects the combinations which can't work, e.g.
+// fetching a string into a number. Any numeric types are compatible, as the
+// backends convert between them, and all columns except BLOBs can be fetched
+// into strings.
+bool is_column_type_compatible(db_type dbtype, exchange_type type)
+{
+    switch (type)
+    {
+        case x_stdstring:
+        case x_stdwstring:
+        case x_longstring:
+            return dbtype != db_blob;
+
+        case x_char:
+            return dbtype == db_string || dbtype == db_wstring || dbtype == db_xml;
+
+        case x_int8:
+        case x_uint8:
+        case x_int16:
+        case x_uint16:
+        case x_int32:
+        case x_uint32:
+        case x_int64:
+        case x_uint64:
+        case x_double:
+            return is_numeric(dbtype);
+
+        case x_stdtm:
+            // Some databases, e.g. SQLite, store dates as strings.
+            return dbtype == db_date || dbtype == db_string;
+
+        case x_xmltype:
+            return dbtype == db_xml || dbtype == db_string;
+
+        case x_blob:
+            return dbtype == db_blob;
+
+        case x_statement:
+        case x_rowid:
+            break;
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
 std::string get_name(const details::use_type_base &param, std::size_t position,
         const statement_backend *backend)
 {
@@ -111,40 +293,17 @@ void statement_impl::bind(values & values)
                 uses_.push_back(*it);
                 indicators_.push_back(values.indicators_[cnt]);
             }
+            else if (has_named_placeholder(useName))
+            {
+                // named use element which is used in the statement
+                int position = isize(uses_);
+                (*it)->bind(*this, position);
+                uses_.push_back(*it);
+                indicators_.push_back(values.indicators_[cnt]);
+            }
             else
             {
-                // named use element - check if it is used
-                std::string const placeholder = ":" + useName;
-
-                std::size_t pos = query_.find(placeholder);
-                while (pos != std::string::npos)
-                {
-                    // Retrieve next char after placeholder
-                    // make sure we do not go out of range on the string
-                    const char nextChar = (pos + placeholder.size()) < query_.size() ?
-                                          query_[pos + placeholder.size()] : '\0';
-
-                    if (std::isalnum(nextChar))
-                    {
-                        // We got a partial match only,
-                        // keep looking for the placeholder
-                        pos = query_.find(placeholder, pos + placeholder.size());
-                    }
-                    else
-                    {
-                        int position = isize(uses_);
-                        (*it)->bind(*this, position);
-                        uses_.push_back(*it);
-                        indicators_.push_back(values.indicators_[cnt]);
-                        // Ok we found it, done
-                        break;
-                    }
-                }
-                // In case we couldn't find the placeholder
-                if (pos == std::string::npos)
-                {
-                    values.add_unused(*it, values.indicators_[cnt]);
-                }
+                values.add_unused(*it, values.indicators_[cnt]);
             }
 
             cnt++;
@@ -161,8 +320,42 @@ void statement_impl::bind(values & values)
     }
 }
 
+bool statement_impl::has_named_placeholder(std::string const & name) const
+{
+    std::string const placeholder = ":" + name;
+
+    std::size_t pos = query_.find(placeholder);
+    while (pos != std::string::npos)
+    {
+        // Retrieve next char after placeholder
+        // make sure we do not go out of range on the string
+        const char nextChar = (pos + placeholder.size()) < query_.size() ?
+                              query_[pos + placeholder.size()] : '\0';
+
+        if (!std::isalnum(nextChar))
+        {
+            return true;
+        }
+
+        // We got a partial match only,
+        // keep looking for the placeholder
+        pos = query_.find(placeholder, pos + placeholder.size());
+    }
+
+    return false;
+}
+
 void statement_impl::bind_clean_up()
 {
+    // The parameters won't be available after this, so let the session take
+    // them now if it still needs them.
+    session_.add_deferred_query_parameters(this);
+
+    if (lazyRow_)
+    {
+        row_->detach_lazy_statement();
+    }
+
     // deallocate all bind and define objects
     std::size_t const isize = intos_.size();
     for (std::size_t i = isize; i != 0; --i)
@@ -197,6 +390,8 @@ void statement_impl::bind_clean_up()
     indicators_.clear();
 
     row_ = nullptr;
+    batch_ = nullptr;
+    firstBatchInto_ = 0;
     alreadyDescribed_ = false;
 }
 
@@ -217,9 +412,15 @@ void statement_impl::prepare(std::string const & query,
     try
     {
         query_ = query;
+        fingerprintComputed_ = false;
         session_.log_query(query);
 
         backEnd_->prepare(query, eType);
+
+        if (statistics_collector * const stats = session_.get_statistics_collector())
+        {
+            stats->add_prepare();
+        }
     }
     catch (...)
     {
@@ -262,6 +463,15 @@ void statement_impl::define_and_bind()
 
 void statement_impl::undefine_and_bind()
 {
+    // The parameters won't be available after this, so let the session take
+    // them now if it still needs them.
+    session_.add_deferred_query_parameters(this);
+
+    if (lazyRow_)
+    {
+        row_->detach_lazy_statement();
+    }
+
     std::size_t const isize = intos_.size();
     for (std::size_t i = isize; i != 0; --i)
     {
@@ -282,9 +492,53 @@ void statement_impl::undefine_and_bind()
 }
 
 bool statement_impl::execute(bool withDataExchange)
+{
+    logger const & log = session_.get_logger();
+    statistics_collector * const stats = session_.get_statistics_collector();
+    if (!log.wants_query_end() && !stats)
+    {
+        return do_execute(withDataExchange);
+    }
+
+    query_end_info info;
+    std::chrono::steady_clock::duration backendTime{};
+    auto const start = std::chrono::steady_clock::now();
+
+    bool gotData = false;
+    try
+    {
+        backendTime_ = stats ? &backendTime : nullptr;
+        gotData = do_execute(withDataExchange);
+        backendTime_ = nullptr;
+    }
+    catch (...)
+    {
+        backendTime_ = nullptr;
+        info.failed = true;
+        end_query(true, log, stats, info, start, backendTime, false);
+        throw;
+    }
+
+    end_query(true, log, stats, info, start, backendTime, gotData);
+
+    return gotData;
+}
+
+bool statement_impl::do_execute(bool withDataExchange)
 {
     try
     {
+        if (batch_ != nullptr)
+        {
+            // The previous fetches could have shrunk the batch vectors, but
+            // each execution must be able to fill the entire batch again.
+            std::size_t const isize = intos_.size();
+            for (std::size_t i = 0; i != isize; ++i)
+            {
+                intos_[i]->resize(batch_->capacity());
+            }
+        }
+
         initialFetchSize_ = intos_size();
 
         if (intos_.empty() == false && initialFetchSize_ == 0)
@@ -314,11 +568,17 @@ bool statement_impl::execute(bool withDataExchange)
         // and *before* the into elements are touched, so that the row
         // description process can inject more into elements for
         // implicit data exchange
-        if (row_ != nullptr && alreadyDescribed_ == false)
+        if ((row_ != nullptr || batch_ != nullptr) && alreadyDescribed_ == false)
         {
+            backend_call_timer timer(backendTime_);
             describe();
         }
 
+        if (!expectedColumns_.empty() && columnsChecked_ == false)
+        {
+            check_columns(false);
+        }
+
         int num = 0;
         if (withDataExchange)
         {
@@ -338,18 +598,28 @@ bool statement_impl::execute(bool withDataExchange)
 
         pre_exec(num);
 
-        statement_backend::exec_fetch_result res = backEnd_->execute(num);
+        statement_backend::exec_fetch_result res;
+        {
+            backend_call_timer timer(backendTime_);
+            res = backEnd_->execute(num);
+        }
 
         // another hack related to description: the first call to describe()
         // above may not have done anything if we didn't have the correct
         // number of columns before calling execute() as happens with at least
         // the ODBC backend for some complex queries (see #1151), so call it
         // again in this case
-        if (row_ != nullptr && alreadyDescribed_ == false)
+        if ((row_ != nullptr || batch_ != nullptr) && alreadyDescribed_ == false)
         {
+            backend_call_timer timer(backendTime_);
             describe();
         }
 
+        if (!expectedColumns_.empty() && columnsChecked_ == false)
+        {
+            check_columns(true);
+        }
+
         bool gotData = false;
 
         if (res == statement_backend::ef_success)
@@ -403,6 +673,100 @@ long long statement_impl::get_affected_rows()
 }
 
 bool statement_impl::fetch()
+{
+    logger const & log = session_.get_logger();
+    statistics_collector * const stats = session_.get_statistics_collector();
+    if (!log.wants_query_end() && !stats)
+    {
+        return do_fetch();
+    }
+
+    query_end_info info;
+    std::chrono::steady_clock::duration backendTime{};
+    auto const start = std::chrono::steady_clock::now();
+
+    bool gotData = false;
+    try
+    {
+        backendTime_ = stats ? &backendTime : nullptr;
+        gotData = do_fetch();
+        backendTime_ = nullptr;
+    }
+    catch (...)
+    {
+        backendTime_ = nullptr;
+        info.failed = true;
+        end_query(false, log, stats, info, start, backendTime, false);
+        throw;
+    }
+
+    end_query(false, log, stats, info, start, backendTime, gotData);
+
+    return gotData;
+}
+
+void statement_impl::end_query(bool isExecute,
+                               logger const & log,
+                               statistics_collector * stats,
+                               query_end_info & info,
+                               std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::duration backendTime,
+                               bool gotData)
+{
+    info.duration = std::chrono::steady_clock::now() - start;
+    info.fingerprint = &get_query_fingerprint();
+
+    if (gotData && !intos_.empty())
+    {
+        info.fetchedRows = intos_size();
+    }
+
+    if (backEnd_)
+    {
+        info.roundTrips = backEnd_->get_round_trips();
+
+        // Only the statements without into elements can affect any rows and
+        // asking for them can require another backend call, so don't do it
+        // for the other ones.
+        if (isExecute && !info.failed && intos_.empty())
+        {
+            try
+            {
+                info.affectedRows = backEnd_->get_affected_rows();
+            }
+            catch (soci_error const &)
+            {
+                // Leave it unknown, this is not worth failing the query for.
+            }
+        }
+    }
+
+    if (log.wants_query_end())
+    {
+        if (isExecute)
+        {
+            log.end_execute(query_, info);
+        }
+        else
+        {
+            log.end_fetch(query_, info);
+        }
+    }
+
+    if (stats)
+    {
+        if (isExecute)
+        {
+            stats->add_execute(info, backendTime);
+        }
+        else
+        {
+            stats->add_fetch(info, backendTime);
+        }
+    }
+}
+
+bool statement_impl::do_fetch()
 {
     try
     {
@@ -436,7 +800,11 @@ bool statement_impl::fetch()
             fetchSize_ = newFetchSize;
         }
 
-        statement_backend::exec_fetch_result const res = backEnd_->fetch(static_cast<int>(fetchSize_));
+        statement_backend::exec_fetch_result res;
+        {
+            backend_call_timer timer(backendTime_);
+            res = backEnd_->fetch(static_cast<int>(fetchSize_));
+        }
         if (res == statement_backend::ef_success)
         {
             // the "success" means that some number of rows was read
@@ -590,18 +958,40 @@ void statement_impl::pre_fetch()
     }
 }
 
-void statement_impl::do_add_query_parameters()
+void statement_impl::do_add_query_parameters(int rowToDump) const
 {
+    std::ostringstream value;
+
     std::size_t const usize = uses_.size();
     for (std::size_t i = 0; i != usize; ++i)
     {
         std::string name = get_name(*uses_[i], i, backEnd_);
-        std::ostringstream value;
-        uses_[i]->dump_value(value, backEnd_->get_row_to_dump());
+
+        value.str(std::string());
+        uses_[i]->dump_value(value, rowToDump);
         session_.add_query_parameter(std::move(name), value.str());
     }
 }
 
+void statement_impl::release_query_parameters(
+    std::vector<std::string> & names,
+    std::vector<use_value_snapshot> & values)
+{
+    // More use elements could have been added since the snapshot was made.
+    std::size_t const usize = std::min(uses_.size(), paramsSnapshot_.size());
+
+    names.clear();
+    names.reserve(usize);
+    for (std::size_t i = 0; i != usize; ++i)
+    {
+        names.push_back(get_name(*uses_[i], i, backEnd_));
+    }
+
+    paramsSnapshot_.resize(usize);
+    values = std::move(paramsSnapshot_);
+    paramsSnapshot_.clear();
+}
+
 void statement_impl::pre_use()
 {
     session_.clear_query_parameters();
@@ -612,9 +1002,23 @@ void statement_impl::pre_use()
         uses_[i]->pre_use();
     }
 
+    // Formatting the parameters is relatively expensive, so only copy their
+    // current values and let the session format them if and when needed.
     if (session_.get_query_context_logging_mode() == log_context::always)
     {
-        do_add_query_parameters();
+        int const rowToDump = backEnd_->get_row_to_dump();
+        if (session_.defer_query_parameters(this))
+        {
+            paramsSnapshot_.resize(usize);
+            for (std::size_t i = 0; i != usize; ++i)
+            {
+                uses_[i]->snapshot_value(paramsSnapshot_[i], rowToDump);
+            }
+        }
+        else
+        {
+            do_add_query_parameters(rowToDump);
+        }
     }
 }
 
@@ -622,17 +1026,29 @@ void statement_impl::post_fetch(bool gotData, bool calledFromFetch)
 {
     // first iterate over intosForRow_ elements, since the Row element
     // (which is among the intos_ elements) might depend on the
-    // values of those implicitly injected elements
+    // values of those implicitly injected elements, unless they're
+    // only going to be used on demand
 
-    std::size_t const ifrsize = intosForRow_.size();
-    for (std::size_t i = 0; i != ifrsize; ++i)
+    if (lazyRow_)
     {
-        intosForRow_[i]->post_fetch(gotData, calledFromFetch);
+        row_->reset_lazy_columns(gotData);
+    }
+    else
+    {
+        std::size_t const ifrsize = intosForRow_.size();
+        for (std::size_t i = 0; i != ifrsize; ++i)
+        {
+            intosForRow_[i]->post_fetch(gotData, calledFromFetch);
+        }
     }
 
+    // similarly, the vectors of the batch columns must be processed before
+    // the element using the batch, which comes before them in intos_
     std::size_t const isize = intos_.size();
-    for (std::size_t i = 0; i != isize; ++i)
+    std::size_t const firstBatchInto = batch_ != nullptr ? firstBatchInto_ : 0;
+    for (std::size_t n = 0; n != isize; ++n)
     {
+        std::size_t const i = (n + firstBatchInto) % isize;
         try
         {
             intos_[i]->post_fetch(gotData, calledFromFetch);
@@ -746,7 +1162,17 @@ void statement_impl::bind_into<db_blob>()
 
 void statement_impl::describe()
 {
-    row_->clean_up();
+    if (batch_ != nullptr)
+    {
+        batch_->clean_up();
+    }
+    else
+    {
+        row_->clean_up();
+    }
+
+    // Column batch vectors are added to the explicit into elements.
+    firstBatchInto_ = intos_.size();
 
     int const numcols = backEnd_->prepare_for_describe();
     if (!numcols)
@@ -756,6 +1182,9 @@ void statement_impl::describe()
         return;
     }
 
+    std::vector<db_type> exchangeTypes;
+    exchangeTypes.reserve(numcols);
+
     for (int i = 1; i <= numcols; ++i)
     {
         db_type dbtype;
@@ -768,7 +1197,27 @@ void statement_impl::describe()
         props.set_db_type(dbtype);
         props.set_data_type(backEnd_->to_data_type(dbtype));
 
-        switch (backEnd_->exchange_dbtype_for(dbtype))
+        exchangeTypes.push_back(backEnd_->exchange_dbtype_for(dbtype));
+
+        if (batch_ != nullptr)
+        {
+            batch_->add_properties(props);
+        }
+        else
+        {
+            row_->add_properties(props);
+        }
+    }
+
+    // Allocate the storage for all row values at once before binding them.
+    if (batch_ == nullptr)
+    {
+        row_->reserve_holders(exchangeTypes);
+    }
+
+    for (db_type const exchangeType : exchangeTypes)
+    {
+        switch (exchangeType)
         {
         case db_string:
         case db_xml:
@@ -812,13 +1261,22 @@ void statement_impl::describe()
             break;
         default:
             throw soci_error(fmt::format("db column type {} not supported for dynamic selects\n",
-                             fmt::underlying(dbtype)));
+                             fmt::underlying(exchangeType)));
         }
-        row_->add_properties(props);
     }
 
     alreadyDescribed_ = true;
 
+    if (batch_ != nullptr)
+    {
+        int definePosition = definePositionForRow_;
+        std::size_t const isize = intos_.size();
+        for (std::size_t i = firstBatchInto_; i != isize; ++i)
+        {
+            intos_[i]->define(*this, definePosition);
+        }
+    }
+
     // Calling bind_into() above could have added row into elements, so
     // initialize them.
     std::size_t const isize = intosForRow_.size();
@@ -826,6 +1284,14 @@ void statement_impl::describe()
     {
         intosForRow_[i]->define(*this, definePositionForRow_);
     }
+
+    if (row_ != nullptr &&
+            session_.get_lazy_row_conversion() &&
+                backEnd_->supports_lazy_row_conversion())
+    {
+        lazyRow_ = true;
+        row_->set_lazy_statement(this);
+    }
 }
 
 } // namespace details
@@ -833,7 +1299,7 @@ void statement_impl::describe()
 
 void statement_impl::set_row(row * r)
 {
-    if (row_ != nullptr)
+    if (row_ != nullptr || batch_ != nullptr)
     {
         throw soci_error(
             "Only one Row element allowed in a single statement.");
@@ -843,6 +1309,87 @@ void statement_impl::set_row(row * r)
     row_->uppercase_column_names(session_.get_uppercase_column_names());
 }
 
+void statement_impl::set_column_batch(column_batch * b)
+{
+    if (row_ != nullptr || batch_ != nullptr)
+    {
+        throw soci_error(
+            "Only one Row element allowed in a single statement.");
+    }
+
+    batch_ = b;
+    batch_->uppercase_column_names(session_.get_uppercase_column_names());
+}
+
+void statement_impl::set_expected_columns(std::vector<exchange_type> const & types)
+{
+    expectedColumns_ = types;
+    columnsChecked_ = false;
+}
+
+query_fingerprint const & statement_impl::get_query_fingerprint()
+{
+    if (!fingerprintComputed_)
+    {
+        fingerprint_ = query_fingerprint(query_,
+                                         session_.get_backend()
+                                            ? session_.get_database_engine()
+                                            : database_engine::unknown);
+        fingerprintComputed_ = true;
+    }
+
+    return fingerprint_;
+}
+
+void statement_impl::check_columns(bool afterExecute)
+{
+    int const numcols = backEnd_->prepare_for_describe();
+
+    // As in describe(), the number of columns may be unknown before
+    // executing the statement, so check it again later in this case.
+    if (numcols == 0 && !afterExecute)
+    {
+        return;
+    }
+
+    if (static_cast<std::size_t>(numcols) != expectedColumns_.size())
+    {
+        throw soci_error(fmt::format("Query returns {} columns instead of the expected {}",
+                                     numcols, expectedColumns_.size()));
+    }
+
+    for (int i = 1; i <= numcols; ++i)
+    {
+        db_type dbtype;
+        std::string columnName;
+        backEnd_->describe_column(i, dbtype, columnName);
+
+        exchange_type const type = expectedColumns_[i - 1];
+        if (!is_column_type_compatible(dbtype, type))
+        {
+            throw soci_error(fmt::format("Column \"{}\" of {} type can't be "
+                                         "fetched into the expected {} type",
+                                         columnName,
+                                         get_type_kind(dbtype),
+                                         get_type_kind(type)));
+        }
+    }
+
+    columnsChecked_ = true;
+}
+
+void statement_impl::load_row_column(std::size_t pos)
+{
+    try
+    {
+        intosForRow_.at(pos)->post_fetch(true, true);
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("fetching data from");
+    }
+}
+
 std::string statement_impl::rewrite_for_procedure_call(std::string const & query)
 {
     return backEnd_->rewrite_for_procedure_call(query);
@@ -897,6 +1444,11 @@ statement_impl::make_vector_use_type_backend()
 void
 statement_impl::rethrow_current_exception_with_context(char const* operation)
 {
+    if (statistics_collector * const stats = session_.get_statistics_collector())
+    {
+        stats->add_exception();
+    }
+
     try
     {
         throw;
@@ -915,7 +1467,7 @@ statement_impl::rethrow_current_exception_with_context(char const* operation)
                 // works for all kinds of errors).
                 session_.clear_query_parameters();
 
-                do_add_query_parameters();
+                do_add_query_parameters(backEnd_->get_row_to_dump());
 
                 ctx += fmt::format(" with {}", session_.get_last_query_context());
             }
@@ -930,8 +1482,13 @@ statement_impl::rethrow_current_exception_with_context(char const* operation)
 template<>
 void statement_impl::into_row<blob>()
 {
-    blob * b = new blob(session_);
-    indicator * ind = new indicator(i_ok);
-    row_->add_holder(b, ind);
+    if (batch_ != nullptr)
+    {
+        throw soci_error("BLOB columns are not supported in column_batch.");
+    }
+
+    blob * b;
+    indicator * ind;
+    row_->add_holder(b, ind, session_);
     exchange_for_row(into(*b, *ind));
 }
@@ -14,6 +14,7 @@
 #include "soci-vector-helpers.h"
 
 #include <cstdio>
+#include <sstream>
 
 using namespace soci;
 using namespace soci::details;
@@ -176,8 +177,131 @@ do_dump_value(std::ostream& os,
     os << "<unknown>";
 }
 
+// Common part of scalar and vector use types.
+void
+do_snapshot_value(use_value_snapshot& s,
+                  exchange_type type,
+                  void* data,
+                  indicator const* ind)
+{
+    s.type = type;
+    s.isNull = ind && *ind == i_null;
+    s.formatted = false;
+
+    if (s.isNull)
+    {
+        return;
+    }
+
+    switch (type)
+    {
+        case x_char:
+            s.scalar.c = exchange_type_cast<x_char>(data);
+            return;
+
+        case x_stdstring:
+            s.str = exchange_type_cast<x_stdstring>(data);
+            return;
+
+        case x_stdwstring:
+            s.wstr = exchange_type_cast<x_stdwstring>(data);
+            return;
+
+        case x_int8:
+            s.scalar.i8 = exchange_type_cast<x_int8>(data);
+            return;
+
+        case x_uint8:
+            s.scalar.u8 = exchange_type_cast<x_uint8>(data);
+            return;
+
+        case x_int16:
+            s.scalar.i16 = exchange_type_cast<x_int16>(data);
+            return;
+
+        case x_uint16:
+            s.scalar.u16 = exchange_type_cast<x_uint16>(data);
+            return;
+
+        case x_int32:
+            s.scalar.i32 = exchange_type_cast<x_int32>(data);
+            return;
+
+        case x_uint32:
+            s.scalar.u32 = exchange_type_cast<x_uint32>(data);
+            return;
+
+        case x_int64:
+            s.scalar.i64 = exchange_type_cast<x_int64>(data);
+            return;
+
+        case x_uint64:
+            s.scalar.u64 = exchange_type_cast<x_uint64>(data);
+            return;
+
+        case x_double:
+            s.scalar.d = exchange_type_cast<x_double>(data);
+            return;
+
+        case x_stdtm:
+            s.tm = exchange_type_cast<x_stdtm>(data);
+            return;
+
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+        case x_xmltype:
+        case x_longstring:
+            // The value of these types is not output by do_dump_value().
+            return;
+    }
+}
+
 } // anonymous namespace
 
+void use_value_snapshot::dump(std::ostream& os) const
+{
+    if (formatted)
+    {
+        os << str;
+        return;
+    }
+
+    indicator const ind = isNull ? i_null : i_ok;
+
+    void* data = nullptr;
+    switch (type)
+    {
+        case x_stdstring:
+            data = const_cast<std::string*>(&str);
+            break;
+
+        case x_stdwstring:
+            data = const_cast<std::wstring*>(&wstr);
+            break;
+
+        case x_stdtm:
+            data = const_cast<std::tm*>(&tm);
+            break;
+
+        default:
+            // All scalar members of the union have the same address.
+            data = const_cast<void*>(static_cast<void const*>(&scalar));
+            break;
+    }
+
+    do_dump_value(os, type, data, &ind);
+}
+
+void use_type_base::snapshot_value(use_value_snapshot& s, int index) const
+{
+    std::ostringstream os;
+    dump_value(os, index);
+
+    s.formatted = true;
+    s.str = os.str();
+}
+
 standard_use_type::~standard_use_type()
 {
     delete backEnd_;
@@ -205,6 +329,11 @@ void standard_use_type::dump_value(std::ostream& os, int /* index */) const
     do_dump_value(os, type_, data_, ind_);
 }
 
+void standard_use_type::snapshot_value(use_value_snapshot& s, int /* index */) const
+{
+    do_snapshot_value(s, type_, data_, ind_);
+}
+
 void standard_use_type::pre_exec(int num)
 {
     backEnd_->pre_exec(num);
@@ -297,6 +426,24 @@ void vector_use_type::dump_value(std::ostream& os, int index) const
     }
 }
 
+void vector_use_type::snapshot_value(use_value_snapshot& s, int index) const
+{
+    if (index != -1)
+    {
+        do_snapshot_value(
+            s,
+            type_,
+            get_vector_element(type_, data_, index),
+            ind_ ? &ind_->at(index) : nullptr
+        );
+    }
+    else
+    {
+        s.formatted = true;
+        s.str = "<vector>";
+    }
+}
+
 void vector_use_type::pre_exec(int num)
 {
     backEnd_->pre_exec(num);
@@ -0,0 +1,416 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/session.h"
+#include "soci/values-exchange.h"
+
+#include <ctime>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Vector bound to the statement for one of the columns of the values used
+// with use_type<std::vector<values> >.
+class values_use_column
+{
+public:
+    values_use_column(std::size_t usePos, exchange_type type)
+        : usePos_(usePos), type_(type)
+    {}
+
+    virtual ~values_use_column() {}
+
+    virtual void resize(std::size_t rows) = 0;
+
+    // Copy the value of the given use element to the given row.
+    virtual void set(std::size_t row, standard_use_type & u) = 0;
+
+    // Position of the corresponding use element in values::uses_.
+    std::size_t const usePos_;
+    exchange_type const type_;
+
+    std::vector<indicator> indicators_;
+    std::unique_ptr<use_type_base> use_;
+};
+
+} // namespace details
+
+} // namespace soci
+
+using namespace soci;
+using namespace soci::details;
+
+namespace
+{
+
+template <typename T>
+class values_use_column_impl : public values_use_column
+{
+public:
+    values_use_column_impl(std::size_t usePos, exchange_type type,
+                           std::string const & name)
+        : values_use_column(usePos, type)
+    {
+        use_.reset(new use_type<std::vector<T> >(values_, indicators_, name));
+    }
+
+    void resize(std::size_t rows) override
+    {
+        values_.resize(rows);
+        indicators_.resize(rows);
+    }
+
+    void set(std::size_t row, standard_use_type & u) override
+    {
+        values_[row] = *static_cast<T *>(u.get_data());
+    }
+
+private:
+    std::vector<T> values_;
+};
+
+values_use_column *
+make_values_use_column(std::size_t usePos, exchange_type type,
+                       std::string const & name)
+{
+    switch (type)
+    {
+    case x_char:
+        return new values_use_column_impl<char>(usePos, type, name);
+    case x_stdstring:
+        return new values_use_column_impl<std::string>(usePos, type, name);
+    case x_stdwstring:
+        return new values_use_column_impl<std::wstring>(usePos, type, name);
+    case x_int8:
+        return new values_use_column_impl<int8_t>(usePos, type, name);
+    case x_uint8:
+        return new values_use_column_impl<uint8_t>(usePos, type, name);
+    case x_int16:
+        return new values_use_column_impl<int16_t>(usePos, type, name);
+    case x_uint16:
+        return new values_use_column_impl<uint16_t>(usePos, type, name);
+    case x_int32:
+        return new values_use_column_impl<int32_t>(usePos, type, name);
+    case x_uint32:
+        return new values_use_column_impl<uint32_t>(usePos, type, name);
+    case x_int64:
+        return new values_use_column_impl<int64_t>(usePos, type, name);
+    case x_uint64:
+        return new values_use_column_impl<uint64_t>(usePos, type, name);
+    case x_double:
+        return new values_use_column_impl<double>(usePos, type, name);
+    case x_stdtm:
+        return new values_use_column_impl<std::tm>(usePos, type, name);
+
+    case x_statement:
+    case x_rowid:
+    case x_blob:
+    case x_xmltype:
+    case x_longstring:
+        break;
+    }
+
+    throw soci_error(
+        "Only basic types are supported in bulk operations with values.");
+}
+
+void check_no_ranges(std::size_t const * end)
+{
+    if (end != nullptr)
+    {
+        throw soci_error(
+            "Vector ranges are not supported in bulk operations with values.");
+    }
+}
+
+} // anonymous namespace
+
+use_type<std::vector<values> >::use_type(std::vector<values> & v,
+    std::string const & /* name */)
+    : v_(v), end_(nullptr), numUses_(0), rows_(0)
+{}
+
+use_type<std::vector<values> >::use_type(std::vector<values> & v,
+    std::size_t /* begin */, std::size_t * end,
+    std::string const & /* name */)
+    : v_(v), end_(end), numUses_(0), rows_(0)
+{}
+
+// we ignore the possibility to have the whole values as NULL
+use_type<std::vector<values> >::use_type(std::vector<values> & v,
+    std::vector<indicator> const & /* ind */,
+    std::string const & /* name */)
+    : v_(v), end_(nullptr), numUses_(0), rows_(0)
+{}
+
+use_type<std::vector<values> >::use_type(std::vector<values> & v,
+    std::vector<indicator> const & /* ind */,
+    std::size_t /* begin */, std::size_t * end,
+    std::string const & /* name */)
+    : v_(v), end_(end), numUses_(0), rows_(0)
+{}
+
+use_type<std::vector<values> >::~use_type() = default;
+
+void use_type<std::vector<values> >::bind(statement_impl & st, int & position)
+{
+    check_no_ranges(end_);
+
+    if (v_.empty())
+    {
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
+
+    // Use the values filled for the first element to find the columns, the
+    // values for all elements are filled again before each execution.
+    convert_to_base();
+
+    values const & first = v_.front();
+    numUses_ = first.uses_.size();
+    for (std::size_t n = 0; n != numUses_; ++n)
+    {
+        standard_use_type & u = *first.uses_[n];
+
+        // only bind those variables which are:
+        // - either named and actually referenced in the statement,
+        // - or positional
+        std::string const name = u.get_name();
+        if (!name.empty() && !st.has_named_placeholder(name))
+        {
+            continue;
+        }
+
+        columns_.emplace_back(make_values_use_column(n, u.get_type(), name));
+        columns_.back()->use_->bind(st, position);
+    }
+
+    clean_up_values();
+}
+
+std::string use_type<std::vector<values> >::get_name() const
+{
+    std::string s;
+
+    s += "(";
+
+    for (std::size_t n = 0; n != columns_.size(); ++n)
+    {
+        if (n != 0)
+            s += ", ";
+
+        s += columns_[n]->use_->get_name();
+    }
+
+    s += ")";
+
+    return s;
+}
+
+void use_type<std::vector<values> >::dump_value(std::ostream& os, int index) const
+{
+    os << "(";
+
+    for (std::size_t n = 0; n != columns_.size(); ++n)
+    {
+        if (n != 0)
+            os << ", ";
+
+        columns_[n]->use_->dump_value(os, index);
+    }
+
+    os << ")";
+}
+
+void use_type<std::vector<values> >::pre_exec(int num)
+{
+    for (auto const & column : columns_)
+    {
+        column->use_->pre_exec(num);
+    }
+}
+
+void use_type<std::vector<values> >::pre_use()
+{
+    convert_to_base();
+
+    rows_ = v_.size();
+    for (auto const & column : columns_)
+    {
+        column->resize(rows_);
+    }
+
+    for (std::size_t row = 0; row != rows_; ++row)
+    {
+        values & v = v_[row];
+        if (v.uses_.size() != numUses_)
+        {
+            throw soci_error("Element {} of the vector has different values "
+                             "than the first one", row);
+        }
+
+        for (auto const & column : columns_)
+        {
+            standard_use_type & u = *v.uses_[column->usePos_];
+            if (u.get_type() != column->type_)
+            {
+                throw soci_error("Element {} of the vector has different values "
+                                 "than the first one", row);
+            }
+
+            column->set(row, u);
+            column->indicators_[row] = *v.indicators_[column->usePos_];
+        }
+    }
+
+    clean_up_values();
+
+    for (auto const & column : columns_)
+    {
+        column->use_->pre_use();
+    }
+}
+
+void use_type<std::vector<values> >::post_use(bool gotData)
+{
+    for (auto const & column : columns_)
+    {
+        column->use_->post_use(gotData);
+    }
+}
+
+void use_type<std::vector<values> >::clean_up()
+{
+    for (auto const & column : columns_)
+    {
+        column->use_->clean_up();
+    }
+
+    columns_.clear();
+
+    clean_up_values();
+}
+
+void use_type<std::vector<values> >::clean_up_values()
+{
+    for (auto & v : v_)
+    {
+        v.clean_up_uses();
+    }
+}
+
+into_type<std::vector<values> >::into_type(std::vector<values> & v)
+    : v_(v), ind_(nullptr), end_(nullptr)
+{}
+
+into_type<std::vector<values> >::into_type(std::vector<values> & v,
+    std::size_t /* begin */, std::size_t * end)
+    : v_(v), ind_(nullptr), end_(end)
+{}
+
+into_type<std::vector<values> >::into_type(std::vector<values> & v,
+    std::vector<indicator> & ind)
+    : v_(v), ind_(&ind), end_(nullptr)
+{}
+
+into_type<std::vector<values> >::into_type(std::vector<values> & v,
+    std::vector<indicator> & ind, std::size_t /* begin */, std::size_t * end)
+    : v_(v), ind_(&ind), end_(end)
+{}
+
+into_type<std::vector<values> >::~into_type() = default;
+
+void into_type<std::vector<values> >::define(statement_impl & st,
+                                              int & /* position */)
+{
+    check_no_ranges(end_);
+
+    if (v_.empty())
+    {
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
+
+    // The batch can already exist if the statement is re-bound, in which case
+    // its columns are still bound to the statement and must be kept.
+    if (!batch_)
+    {
+        batch_.reset(new column_batch(v_.size()));
+    }
+
+    st.set_column_batch(batch_.get());
+
+    // actual columns description is performed as part of the statement
+    // execute and the vectors for them are bound at that time
+}
+
+void into_type<std::vector<values> >::post_fetch(bool gotData,
+                                                  bool /* calledFromFetch */)
+{
+    if (!gotData)
+    {
+        return;
+    }
+
+    std::size_t const rows = v_.size();
+    if (ind_ != nullptr)
+    {
+        ind_->resize(rows);
+    }
+
+    for (std::size_t row = 0; row != rows; ++row)
+    {
+        v_[row].set_batch_row(batch_.get(), row);
+
+        if (ind_ != nullptr)
+        {
+            (*ind_)[row] = i_ok;
+        }
+    }
+
+    convert_from_base();
+}
+
+void into_type<std::vector<values> >::clean_up()
+{
+    for (auto & v : v_)
+    {
+        v.set_batch_row(nullptr, 0);
+    }
+}
+
+std::size_t into_type<std::vector<values> >::size() const
+{
+    // the user might have resized the vector in the meantime, so keep the
+    // vectors of the batch columns, which are compared with it, in sync
+    std::size_t const sz = v_.size();
+    if (batch_)
+    {
+        batch_->resize_columns(sz);
+    }
+
+    return sz;
+}
+
+void into_type<std::vector<values> >::resize(std::size_t sz)
+{
+    v_.resize(sz);
+
+    if (ind_ != nullptr)
+    {
+        ind_->resize(sz);
+    }
+
+    if (batch_)
+    {
+        batch_->set_number_of_rows(sz);
+    }
+}
@@ -22,6 +22,10 @@ indicator values::get_indicator(std::size_t pos) const
     {
         return row_->get_indicator(pos);
     }
+    else if (batch_)
+    {
+        return batch_->get_indicators(pos).at(batchRow_);
+    }
     else
     {
         return *indicators_[pos];
@@ -34,6 +38,10 @@ indicator values::get_indicator(std::string const& name) const
     {
         return row_->get_indicator(name);
     }
+    else if (batch_)
+    {
+        return batch_->get_indicators(name).at(batchRow_);
+    }
     else
     {
         std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
@@ -45,6 +53,37 @@ indicator values::get_indicator(std::string const& name) const
     }
 }
 
+indicator values::get_indicator(column_ref const& col) const
+{
+    if (row_)
+    {
+        return row_->get_indicator(col);
+    }
+
+    return batch_ ? get_indicator(col.pos_) : *indicators_.at(col.pos_);
+}
+
+column_ref values::get_column_ref(std::string const& name) const
+{
+    if (row_)
+    {
+        return row_->get_column_ref(name);
+    }
+
+    if (batch_)
+    {
+        return column_ref(batch_->find_column(name), 0);
+    }
+
+    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
+    if (it == index_.end())
+    {
+        throw soci_error(fmt::format("Column '{}' not found", name));
+    }
+
+    return column_ref(it->second, 0);
+}
+
 column_properties const& values::get_properties(std::size_t pos) const
 {
     if (row_)
@@ -52,6 +91,11 @@ column_properties const& values::get_properties(std::size_t pos) const
         return row_->get_properties(pos);
     }
 
+    if (batch_)
+    {
+        return batch_->get_properties(pos);
+    }
+
     throw soci_error("Rowset is empty");
 }
 
@@ -62,5 +106,10 @@ column_properties const& values::get_properties(std::string const& name) const
         return row_->get_properties(name);
     }
 
+    if (batch_)
+    {
+        return batch_->get_properties(name);
+    }
+
     throw soci_error("Rowset is empty");
 }
@@ -2389,6 +2389,58 @@ TEST_CASE_METHOD(common_tests, "Bulk fetch with single use", "[core][bulk]")
     CHECK(names[2] == "julian");
 }
 
+TEST_CASE_METHOD(common_tests, "Typed statement", "[core][bulk][typed]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    typed_statement<std::tuple<>, std::tuple<int, std::string>>
+        ins(sql, "insert into soci_test(id, name) values(:id, :name)");
+    for (int i = 0; i != 5; ++i)
+    {
+        ins.execute(i, "name" + std::to_string(i));
+    }
+
+    typed_statement<std::tuple<int, std::string>, std::tuple<int>>
+        sel(sql, "select id, name from soci_test where id >= :id order by id",
+            prefetch(2));
+
+    std::tuple<int, std::string> r;
+
+    sel.execute(1);
+    int expected = 1;
+    while (sel.fetch(r))
+    {
+        CHECK(std::get<0>(r) == expected);
+        CHECK(std::get<1>(r) == "name" + std::to_string(expected));
+        ++expected;
+    }
+    CHECK(expected == 5);
+
+    // The statement can be executed again with different parameters.
+    sel.execute(4);
+    REQUIRE(sel.fetch(r));
+    CHECK(std::get<0>(r) == 4);
+    CHECK_FALSE(sel.fetch(r));
+
+    sel.execute(10);
+    CHECK_FALSE(sel.fetch(r));
+
+    // The number of columns is checked when the statement is executed.
+    typed_statement<std::tuple<int>>
+        wrong(sql, "select id, name from soci_test");
+    CHECK_THROWS_WITH(wrong.execute(),
+                      Catch::Contains("returns 2 columns instead of the expected 1"));
+
+    // And so are their types.
+    typed_statement<std::tuple<int, int>>
+        wrongType(sql, "select id, name from soci_test");
+    CHECK_THROWS_WITH(wrongType.execute(),
+                      Catch::Contains("fetched into the expected numeric type") &&
+                      Catch::Contains("name"));
+}
+
 // test for basic logging support
 TEST_CASE_METHOD(common_tests, "Basic logging support", "[core][logging]")
 {
@@ -3960,6 +4012,359 @@ TEST_CASE_METHOD(common_tests, "Logger", "[core][log]")
     sql.set_logger(logger_orig);
 }
 
+TEST_CASE_METHOD(common_tests, "Deferred query parameters", "[core][log]")
+{
+    // Logger class used for testing: counts the parameters added to it.
+    class test_log_impl : public soci::logger_impl
+    {
+    public:
+        explicit test_log_impl(int& count)
+            : m_count(count)
+        {
+        }
+
+        void add_query_parameter(std::string name, std::string value) override
+        {
+            ++m_count;
+            logger_impl::add_query_parameter(std::move(name), std::move(value));
+        }
+
+    private:
+        logger_impl* do_clone() const override
+        {
+            return new test_log_impl(m_count);
+        }
+
+        int& m_count;
+    };
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    int id = 0;
+    std::string name;
+    {
+        statement st = (sql.prepare <<
+            "insert into soci_test(id, name) values(:id, :name)",
+            use(id, "id"), use(name, "name"));
+
+        for (int i = 1; i <= 3; ++i)
+        {
+            id = i;
+            name = "name" + std::to_string(i);
+            st.execute(true);
+        }
+
+        // With the standard logger, the parameters are only formatted when
+        // the context is needed, but still use their values at the time of
+        // the last execution.
+        id = 42;
+        CHECK( sql.get_last_query_context() == R"(:id=3, :name="name3")" );
+
+        st.execute(true);
+        id = 43;
+    }
+
+    // Destroying the statement doesn't change the context either.
+    CHECK( sql.get_last_query_context() == R"(:id=42, :name="name3")" );
+
+    // Use element counting how many times its value was formatted.
+    class counting_use_type : public details::standard_use_type
+    {
+    public:
+        counting_use_type(int& value, int& count)
+            : standard_use_type(&value, details::x_int32, false, "id"),
+              m_count(count)
+        {
+        }
+
+        void dump_value(std::ostream& os, int index) const override
+        {
+            ++m_count;
+            standard_use_type::dump_value(os, index);
+        }
+
+    private:
+        int& m_count;
+    };
+
+    // One-shot statements don't format their parameters when they're
+    // destroyed either, but the context is still available later.
+    REQUIRE( sql.get_query_context_logging_mode() == log_context::always );
+
+    int dumpCount = 0;
+    id = 17;
+    sql << "insert into soci_test(id) values(:id)",
+        details::use_type_ptr(new counting_use_type(id, dumpCount));
+    CHECK( dumpCount == 0 );
+
+    id = 18;
+    CHECK( sql.get_last_query_context() == ":id=17" );
+    CHECK( dumpCount == 0 );
+
+    // Custom loggers are still called for each execution.
+    int count = 0;
+    sql.set_logger(new test_log_impl(count));
+    {
+        statement st = (sql.prepare <<
+            "insert into soci_test(id, name) values(:id, :name)",
+            use(id, "id"), use(name, "name"));
+
+        for (int i = 1; i <= 3; ++i)
+        {
+            id = 100 + i;
+            st.execute(true);
+        }
+
+        CHECK( count == 6 );
+        id = 0;
+        CHECK( sql.get_last_query_context() == R"(:id=103, :name="name3")" );
+    }
+
+    CHECK( count == 6 );
+}
+
+TEST_CASE_METHOD(common_tests, "Query end logging", "[core][log]")
+{
+    // Logger class used for testing: remembers the information about the
+    // completed operations.
+    class test_log_impl : public soci::logger_impl
+    {
+    public:
+        struct entry
+        {
+            bool execute;
+            std::string query;
+            soci::query_end_info info;
+        };
+
+        explicit test_log_impl(std::vector<entry>& entries)
+            : m_entries(entries)
+        {
+        }
+
+        bool wants_query_end() const override { return true; }
+
+        void end_execute(std::string const & query,
+                         soci::query_end_info const & info) override
+        {
+            m_entries.push_back({true, query, info});
+        }
+
+        void end_fetch(std::string const & query,
+                       soci::query_end_info const & info) override
+        {
+            m_entries.push_back({false, query, info});
+        }
+
+    private:
+        logger_impl* do_clone() const override
+        {
+            return new test_log_impl(m_entries);
+        }
+
+        std::vector<entry>& m_entries;
+    };
+
+    // This vector must outlive the session as the logger is also used when
+    // dropping the table.
+    std::vector<test_log_impl::entry> entries;
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql.set_logger(new test_log_impl(entries));
+
+    std::vector<int> ids{1, 2, 3};
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    REQUIRE( entries.size() == 1 );
+    CHECK( entries[0].execute );
+    CHECK( entries[0].query == "insert into soci_test(id) values(:id)" );
+    CHECK( entries[0].info.affectedRows == 3 );
+    CHECK( entries[0].info.fetchedRows == 0 );
+    CHECK( !entries[0].info.failed );
+    CHECK( entries[0].info.duration >= std::chrono::steady_clock::duration::zero() );
+    entries.clear();
+
+    std::vector<int> out(2);
+    statement st = (sql.prepare << "select id from soci_test order by id",
+                    into(out));
+    st.execute();
+    REQUIRE( entries.size() == 1 );
+    CHECK( entries[0].execute );
+    CHECK( entries[0].info.affectedRows == -1 );
+    CHECK( entries[0].info.fetchedRows == 0 );
+
+    CHECK( st.fetch() );
+    CHECK( st.fetch() );
+    CHECK( !st.fetch() );
+    REQUIRE( entries.size() == 4 );
+    CHECK( !entries[1].execute );
+    CHECK( entries[1].info.fetchedRows == 2 );
+    CHECK( entries[2].info.fetchedRows == 1 );
+    CHECK( entries[3].info.fetchedRows == 0 );
+    entries.clear();
+
+    // Using an empty vector is an error detected when executing the query.
+    std::vector<int> empty;
+    CHECK_THROWS_AS( (sql << "select id from soci_test", into(empty)), soci_error );
+    REQUIRE( entries.size() == 1 );
+    CHECK( entries[0].info.failed );
+}
+
+TEST_CASE_METHOD(common_tests, "Session statistics", "[core][statistics]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    // Nothing is collected by default.
+    CHECK( !sql.get_collect_statistics() );
+    sql << "insert into soci_test(id) values(0)";
+    CHECK( sql.get_statistics().statements_executed == 0 );
+
+    sql.collect_statistics(true);
+
+    std::vector<int> ids{1, 2, 3};
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    std::vector<int> out(10);
+    sql << "select id from soci_test", into(out);
+    CHECK( out.size() == 4 );
+
+    std::vector<int> empty;
+    CHECK_THROWS_AS( (sql << "select id from soci_test", into(empty)), soci_error );
+
+    auto stats = sql.get_statistics();
+    CHECK( stats.statements_prepared == 3 );
+    CHECK( stats.statements_executed == 3 );
+    CHECK( stats.cache_hits == 0 );
+    CHECK( stats.rows_fetched == 4 );
+    CHECK( stats.exceptions == 1 );
+    CHECK( stats.backend_time + stats.conversion_time > std::chrono::nanoseconds(0) );
+
+    REQUIRE( stats.top_queries.size() == 2 );
+    CHECK( stats.top_queries[0].total_time >= stats.top_queries[1].total_time );
+
+    auto const& select = stats.top_queries[0].query == "select id from soci_test"
+                            ? stats.top_queries[0]
+                            : stats.top_queries[1];
+    CHECK( select.query == "select id from soci_test" );
+    CHECK( select.executions == 2 );
+    CHECK( select.errors == 1 );
+    CHECK( select.rows == 4 );
+
+    CHECK( sql.get_statistics(1).top_queries.size() == 1 );
+
+    // Disabling the collection keeps the statistics, but resetting them
+    // doesn't.
+    sql.collect_statistics(false);
+    sql << "select id from soci_test", into(out);
+    CHECK( sql.get_statistics().statements_executed == 3 );
+
+    sql.reset_statistics();
+    stats = sql.get_statistics();
+    CHECK( stats.statements_executed == 0 );
+    CHECK( stats.top_queries.empty() );
+
+    // Queries differing only in their literals are grouped together.
+    sql.collect_statistics(true);
+    for (int i = 0; i != 3; ++i)
+    {
+        sql << "select id from soci_test where id = " << i, into(out);
+    }
+
+    stats = sql.get_statistics();
+    REQUIRE( stats.top_queries.size() == 1 );
+    CHECK( stats.top_queries[0].query == "select id from soci_test where id=?" );
+    CHECK( stats.top_queries[0].executions == 3 );
+}
+
+TEST_CASE("Query fingerprint", "[core][fingerprint]")
+{
+    auto const normalize = [](std::string const & query,
+                              database_engine engine = database_engine::unknown)
+    {
+        return query_fingerprint(query, engine).str();
+    };
+
+    CHECK( normalize("") == "" );
+    CHECK( normalize("  select  *\n\tfrom t  ") == "select*from t" );
+
+    // Literals are replaced, but identifiers and placeholders are kept.
+    CHECK( normalize("select a1 from t2 where x = 'it''s' and y = 1.5e-3")
+            == "select a1 from t2 where x=? and y=?" );
+    CHECK( normalize("update t set x = :x, y = -1 where \"id 1\" = N'abc'")
+            == "update t set x=:x,y=? where \"id 1\"=?" );
+    CHECK( normalize("select 0x1F, .5, X'0A'") == "select ?,?,?" );
+
+    // Lists consisting only of literals are collapsed.
+    CHECK( normalize("select * from t where id in (1, 2, 3)")
+            == "select*from t where id in(...)" );
+    CHECK( normalize("select * from t where id in ( 'a' ,'b' )")
+            == "select*from t where id in(...)" );
+    CHECK( normalize("insert into t(a, b) values (-1, 'x')")
+            == "insert into t(a,b)values(...)" );
+    CHECK( normalize("select f(a, 1) from t") == "select f(a,?)from t" );
+    CHECK( normalize("select * from t where id in (:a, :b)")
+            == "select*from t where id in(:a,:b)" );
+
+    // Signs are part of the numbers unless they're binary operators.
+    CHECK( normalize("select * from t where id = -1")
+            == normalize("select * from t where id = 1") );
+    CHECK( normalize("select * from t where id=-1")
+            == normalize("select * from t where id = -1") );
+    CHECK( normalize("select -1, +.5 from t where x > -1 limit -1")
+            == "select ?,? from t where x>? limit ?" );
+    CHECK( normalize("select case when x then -1 else - 2 end") ==
+            "select case when x then ? else ? end" );
+    CHECK( normalize("select a - 1, (b)+1, ? -1") == "select a-?,(b)+?,?-?" );
+
+    // Whitespace around punctuation doesn't matter.
+    CHECK( normalize("select a , b from t") == normalize("select a, b from t") );
+    CHECK( normalize("select f( a )from t") == normalize("select f(a) from t") );
+    CHECK( normalize("select a - -b") == "select a- -b" );
+
+    // Comments are removed.
+    CHECK( normalize("select 1 -- one\nfrom t /* comment */ where 1=1")
+            == "select ? from t where ?=?" );
+
+    // Backend-specific syntax is taken into account.
+    CHECK( normalize("select \"x\" from `t`", database_engine::mysql)
+            == "select ? from `t`" );
+    CHECK( normalize("select 'a\\'b' # comment", database_engine::mysql)
+            == "select ?" );
+    CHECK( normalize("select $$it's$$, $tag$a$$b$tag$, $1", database_engine::postgresql)
+            == "select ?,?,$1" );
+    CHECK( normalize("select E'a\\'b', x::int", database_engine::postgresql)
+            == "select ?,x::int" );
+    CHECK( normalize("select [a b] from t where x = 1", database_engine::mssql)
+            == "select [a b] from t where x=?" );
+
+    // The hash only depends on the normalized query.
+    query_fingerprint const f1("select * from t where id = 1");
+    query_fingerprint const f2("select  *  from t where id = 42");
+    query_fingerprint const f3("select * from u where id = 1");
+    CHECK( f1 == f2 );
+    CHECK( f1.hash() == f2.hash() );
+    CHECK( f1 != f3 );
+    CHECK( f1.hash() != f3.hash() );
+
+    // Long queries work too, including when the list is collapsed after the
+    // inline buffer had overflowed.
+    std::string longQuery = "select * from t where id in (";
+    for (int i = 0; i != 200; ++i)
+    {
+        longQuery += std::to_string(i);
+        longQuery += ", ";
+    }
+    longQuery += "200) and name = '" + std::string(300, 'x') + "'";
+
+    query_fingerprint const f4(longQuery);
+    CHECK( f4.str() == "select*from t where id in(...)and name=?" );
+    CHECK( f4 == query_fingerprint("select * from t where id in (1) and name = ''") );
+}
+
 } // namespace test_cases
 
 // Implement test_context_common ctor here: like this, just using this class
@@ -3972,6 +4377,7 @@ extern volatile bool soci_use_test_custom;
 extern volatile bool soci_use_test_dynamic;
 extern volatile bool soci_use_test_lob;
 extern volatile bool soci_use_test_manual;
+extern volatile bool soci_use_test_pool;
 extern volatile bool soci_use_test_rowset;
 
 test_context_common::test_context_common()
@@ -3985,6 +4391,7 @@ test_context_common::test_context_common()
     soci_use_test_dynamic = true;
     soci_use_test_lob = true;
     soci_use_test_manual = true;
+    soci_use_test_pool = true;
     soci_use_test_rowset = true;
 }
 
@@ -6,6 +6,7 @@
 //
 
 #include "soci/soci.h"
+#include "soci/arrow.h"
 
 #include <catch.hpp>
 
@@ -150,6 +151,67 @@ TEST_CASE_METHOD(common_tests, "Partial match with ORM", "[core][orm]")
     CHECK(out.phone == "phone1");
 }
 
+TEST_CASE_METHOD(common_tests, "Bulk operations with ORM", "[core][orm][bulk]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    sql.uppercase_column_names(true);
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    std::vector<PhonebookEntry> in(3);
+    in[0].name = "name1";
+    in[0].phone = "phone1";
+    in[1].name = "name2";
+    in[2].name = "name3";
+    in[2].phone = "phone3";
+
+    statement st = (sql.prepare <<
+        "insert into soci_test values (:NAME, :PHONE)", use(in));
+    st.execute(true);
+
+    // The same statement can be reused with a vector of a different size.
+    in.resize(4);
+    for (std::size_t n = 0; n != in.size(); ++n)
+    {
+        in[n].name = "other" + std::to_string(n);
+        in[n].phone = "phone";
+    }
+    st.execute(true);
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 7);
+
+    std::vector<PhonebookEntry> out(2);
+    statement st2 = (sql.prepare <<
+        "select name, phone from soci_test where name like 'name%' order by name",
+        into(out));
+    st2.execute();
+
+    std::vector<PhonebookEntry> all;
+    while (st2.fetch())
+    {
+        CHECK(out.size() <= 2);
+        all.insert(all.end(), out.begin(), out.end());
+        out.resize(2);
+    }
+
+    REQUIRE(all.size() == 3);
+    CHECK(all[0].name == "name1");
+    CHECK(all[0].phone == "phone1");
+    CHECK(all[1].name == "name2");
+    CHECK(all[1].phone == "<NULL>");
+    CHECK(all[2].name == "name3");
+    CHECK(all[2].phone == "phone3");
+
+    // Vectors of types using values::get_indicator() work too.
+    std::vector<PhonebookEntry2> out2(10);
+    sql << "select * from soci_test where name like 'name%' order by name",
+        into(out2);
+    REQUIRE(out2.size() == 3);
+    CHECK(out2[1].name == "name2");
+    CHECK(out2[1].phone == "<NULL>");
+}
+
 // Dynamic binding to Row objects
 TEST_CASE_METHOD(common_tests, "Dynamic row binding", "[core][dynamic]")
 {
@@ -684,6 +746,316 @@ TEST_CASE_METHOD(common_tests, "Dynamic binding with rowset", "[core][dynamic][t
     }
 }
 
+// Dynamic binding to column batches
+TEST_CASE_METHOD(common_tests, "Dynamic row with many columns", "[core][dynamic]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+
+    int const numCols = 40;
+    std::string query = "select ";
+    for (int i = 0; i != numCols; ++i)
+    {
+        if (i)
+            query += ", ";
+        query += "'v" + std::to_string(i) + "' as c" + std::to_string(i);
+    }
+    query += sql.get_dummy_from_clause();
+
+    row r;
+    statement st = (sql.prepare << query, into(r));
+
+    // Execute the statement several times to check that the row storage can
+    // be reused.
+    for (int n = 0; n != 2; ++n)
+    {
+        REQUIRE(st.execute(true));
+        REQUIRE(r.size() == static_cast<std::size_t>(numCols));
+
+        for (int i = 0; i != numCols; ++i)
+        {
+            std::string const col = "C" + std::to_string(i);
+            CHECK(r.get<std::string>(col) == "v" + std::to_string(i));
+            CHECK(r.get_properties(col).get_name() == col);
+        }
+
+        CHECK_THROWS_AS(r.get<std::string>("C40"), soci_error);
+    }
+
+    // Using the same row with a different query must work too.
+    sql << "select 'x' as c0" << sql.get_dummy_from_clause(), into(r);
+    REQUIRE(r.size() == 1);
+    CHECK(r.get<std::string>("C0") == "x");
+    CHECK_THROWS_AS(r.get<std::string>("C1"), soci_error);
+}
+
+TEST_CASE_METHOD(common_tests, "Dynamic row column references", "[core][dynamic]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+
+    auto_table_creator tableCreator(tc_.table_creator_2(sql));
+
+    sql << "insert into soci_test(num_int, name) values(1, 'one')";
+    sql << "insert into soci_test(num_int, name) values(2, null)";
+
+    rowset<row> rs = (sql.prepare <<
+        "select num_int, name from soci_test order by num_int");
+
+    column_ref colInt, colName;
+    std::string names;
+    for (auto const& r : rs)
+    {
+        if (names.empty())
+        {
+            colInt = r.get_column_ref("NUM_INT");
+            colName = r.get_column_ref("NAME");
+            CHECK(colName.get_position() == 1);
+            CHECK(r.get_properties(colInt).get_name() == "NUM_INT");
+            CHECK_THROWS_AS(r.get_column_ref("NO_SUCH_COLUMN"), soci_error);
+        }
+
+        names += std::to_string(r.get<int>(colInt));
+        names += r.get<std::string>(colName, "-");
+        if (r.get_indicator(colName) == i_ok)
+        {
+            names += r.get<std::string>(colName);
+        }
+    }
+
+    CHECK(names == "1oneone2-");
+
+#ifndef NDEBUG
+    // Using a reference with a row with different columns is detected.
+    row r;
+    sql << "select name, num_int from soci_test where num_int = 1", into(r);
+    CHECK_THROWS_AS(r.get<int>(colInt), soci_error);
+#endif
+}
+
+TEST_CASE_METHOD(common_tests, "Dynamic row lazy conversion", "[core][dynamic]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+    sql.lazy_row_conversion(true);
+
+    auto_table_creator tableCreator(tc_.table_creator_2(sql));
+
+    sql << "insert into soci_test(num_float, num_int, name, chr)"
+           " values(1.5, 1, 'one', 'a')";
+    sql << "insert into soci_test(num_float, num_int, name, chr)"
+           " values(2.5, 2, null, 'b')";
+    sql << "insert into soci_test(num_float, num_int, name, chr)"
+           " values(3.5, 3, 'three', 'c')";
+
+    SECTION("statement")
+    {
+        row r;
+        statement st = (sql.prepare <<
+            "select num_int, name, chr from soci_test order by num_int",
+            into(r));
+        st.execute();
+
+        // Only access some columns of each row.
+        int sum = 0;
+        std::string names;
+        while (st.fetch())
+        {
+            sum += r.get<int>("NUM_INT");
+            names += r.get<std::string>("NAME", "-");
+        }
+
+        CHECK(sum == 6);
+        CHECK(names == "one-three");
+    }
+
+    SECTION("rowset")
+    {
+        rowset<row> rs = (sql.prepare <<
+            "select num_int, name from soci_test order by num_int");
+
+        std::string names;
+        for (auto const& r : rs)
+        {
+            if (r.get_indicator(1) == i_null)
+            {
+                names += std::to_string(r.get<int>(0));
+            }
+            else
+            {
+                names += r.get<std::string>(1);
+            }
+        }
+
+        CHECK(names == "one2three");
+    }
+
+    SECTION("after the end of the statement")
+    {
+        row r;
+        sql << "select num_int, name, chr from soci_test where num_int = 3",
+               into(r);
+        REQUIRE(sql.got_data());
+
+        CHECK(r.get<int>(0) == 3);
+        CHECK(r.get<std::string>(1) == "three");
+        CHECK(r.get<std::string>(2) == "c");
+
+        row moved(std::move(r));
+        CHECK(moved.get<std::string>(1) == "three");
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Dynamic column batch binding", "[core][dynamic]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    for (int i = 0; i != 7; ++i)
+    {
+        std::string const name = "name" + std::to_string(i);
+        std::string const phone = "phone" + std::to_string(i);
+        indicator ind = i == 4 ? i_null : i_ok;
+        sql << "insert into soci_test(name, phone) values(:name, :phone)",
+            use(name), use(phone, ind);
+    }
+
+    column_batch batch(3);
+    statement st = (sql.prepare <<
+        "select name, phone from soci_test order by name", into(batch));
+    st.execute();
+
+    std::vector<std::size_t> sizes;
+    std::vector<std::string> names;
+    while (st.fetch())
+    {
+        REQUIRE(batch.get_number_of_columns() == 2);
+        CHECK(batch.get_properties(0).get_name() == "NAME");
+        CHECK(batch.get_properties(1).get_db_type() == db_string);
+
+        sizes.push_back(batch.get_number_of_rows());
+
+        std::vector<std::string> const& phones = batch.get_column<std::string>("PHONE");
+        std::vector<indicator> const& inds = batch.get_indicators(1);
+        for (std::size_t n = 0; n != batch.get_number_of_rows(); ++n)
+        {
+            std::string const name = batch.get<std::string>(n, 0);
+            names.push_back(name);
+
+            if (name == "name4")
+            {
+                CHECK(inds[n] == i_null);
+                CHECK_THROWS_AS(batch.get<std::string>(n, 1), soci_error);
+            }
+            else
+            {
+                CHECK(inds[n] == i_ok);
+                CHECK(phones[n] == "phone" + name.substr(4));
+            }
+        }
+    }
+
+    REQUIRE(sizes.size() == 3);
+    CHECK(sizes[0] == 3);
+    CHECK(sizes[1] == 3);
+    CHECK(sizes[2] == 1);
+
+    REQUIRE(names.size() == 7);
+    CHECK(names.front() == "name0");
+    CHECK(names.back() == "name6");
+
+    CHECK_THROWS_AS(batch.get_column<int>(0), std::bad_cast);
+    CHECK_THROWS_AS(batch.get_column<std::string>("NO_SUCH_COLUMN"), soci_error);
+
+    // The statement can be executed again after fetching all the rows, and
+    // the full batches are used again even if the last one was partial.
+    st.execute();
+    sizes.clear();
+    while (st.fetch())
+    {
+        sizes.push_back(batch.get_number_of_rows());
+        CHECK(batch.get_column<std::string>(0).size() == sizes.back());
+    }
+
+    REQUIRE(sizes.size() == 3);
+    CHECK(sizes[0] == 3);
+    CHECK(sizes[1] == 3);
+    CHECK(sizes[2] == 1);
+
+    // Check that the first batch can be also fetched when executing.
+    column_batch batch2(10);
+    sql << "select name, phone from soci_test", into(batch2);
+    CHECK(batch2.get_number_of_rows() == 7);
+}
+
+TEST_CASE_METHOD(common_tests, "Arrow export", "[core][dynamic][arrow]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    sql << "insert into soci_test(name, phone) values('john', '123')";
+    sql << "insert into soci_test(name, phone) values('mary', null)";
+    sql << "insert into soci_test(name, phone) values('x', '45')";
+
+    column_batch batch(10);
+    sql << "select name, phone from soci_test order by name", into(batch);
+    REQUIRE(batch.get_number_of_rows() == 3);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    export_to_arrow(batch, &schema, &array);
+
+    CHECK(std::string(schema.format) == "+s");
+    REQUIRE(schema.n_children == 2);
+    CHECK(std::string(schema.children[1]->format) == "u");
+    CHECK(schema.children[1]->flags == ARROW_FLAG_NULLABLE);
+
+    CHECK(array.length == 3);
+    REQUIRE(array.n_children == 2);
+
+    ArrowArray const& names = *array.children[0];
+    CHECK(names.null_count == 0);
+    REQUIRE(names.n_buffers == 3);
+    CHECK(names.buffers[0] == nullptr);
+
+    int32_t const* offsets = static_cast<int32_t const*>(names.buffers[1]);
+    char const* chars = static_cast<char const*>(names.buffers[2]);
+    CHECK(std::string(chars + offsets[0], offsets[1] - offsets[0]) == "john");
+    CHECK(std::string(chars + offsets[1], offsets[2] - offsets[1]) == "mary");
+    CHECK(std::string(chars + offsets[2], offsets[3] - offsets[2]) == "x");
+
+    ArrowArray const& phones = *array.children[1];
+    CHECK(phones.null_count == 1);
+    REQUIRE(phones.buffers[0] != nullptr);
+    CHECK(*static_cast<unsigned char const*>(phones.buffers[0]) == 5);
+
+    offsets = static_cast<int32_t const*>(phones.buffers[1]);
+    chars = static_cast<char const*>(phones.buffers[2]);
+    CHECK(offsets[1] - offsets[0] == 3);
+    CHECK(offsets[2] == offsets[1]);
+    CHECK(std::string(chars + offsets[2], offsets[3] - offsets[2]) == "45");
+
+    // Children can be moved out and released independently of the parent.
+    ArrowArray child = *array.children[0];
+    array.children[0]->release = nullptr;
+
+    array.release(&array);
+    CHECK(array.release == nullptr);
+
+    child.release(&child);
+    CHECK(child.release == nullptr);
+
+    schema.release(&schema);
+    CHECK(schema.release == nullptr);
+}
+
 } // namespace tests
 
 } // namespace soci
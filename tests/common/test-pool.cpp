@@ -0,0 +1,549 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/soci.h"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "test-context.h"
+
+namespace soci
+{
+
+namespace tests
+{
+
+// This variable is referenced from test-common.cpp to force linking this file.
+volatile bool soci_use_test_pool = false;
+
+TEST_CASE("Connection pool leasing", "[core][pool]")
+{
+    // Use a size which is not a multiple of the bitmap word size.
+    std::size_t const poolSize = 70;
+    connection_pool pool(poolSize);
+
+    std::vector<std::size_t> leased;
+    for (std::size_t i = 0; i != poolSize; ++i)
+    {
+        std::size_t pos = poolSize;
+        REQUIRE( pool.try_lease(pos, 0) );
+        CHECK( pos < poolSize );
+        leased.push_back(pos);
+    }
+
+    std::sort(leased.begin(), leased.end());
+    CHECK( std::unique(leased.begin(), leased.end()) == leased.end() );
+
+    std::size_t pos = 0;
+    CHECK( !pool.try_lease(pos, 0) );
+    CHECK( !pool.try_lease(pos, 10) );
+
+    pool.give_back(17);
+    CHECK_THROWS_AS( pool.give_back(17), soci_error );
+    CHECK_THROWS_AS( pool.give_back(poolSize), soci_error );
+
+    REQUIRE( pool.try_lease(pos, 0) );
+    CHECK( pos == 17 );
+
+    // Check that a waiting thread gets the entry given back by another one.
+    std::thread t([&pool]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pool.give_back(42);
+    });
+
+    CHECK( pool.lease() == 42 );
+
+    t.join();
+}
+
+TEST_CASE("Connection pool concurrent use", "[core][pool]")
+{
+    std::size_t const poolSize = 5;
+    connection_pool pool(poolSize);
+
+    std::vector<std::atomic<int>> inUse(poolSize);
+    for (auto& n : inUse)
+        n = 0;
+
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for (int n = 0; n != 16; ++n)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i != 1000; ++i)
+            {
+                std::size_t const pos = pool.lease();
+                if (++inUse[pos] != 1)
+                    ++errors;
+                --inUse[pos];
+                pool.give_back(pos);
+            }
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    CHECK( errors == 0 );
+
+    // All entries must be free again.
+    std::size_t pos;
+    for (std::size_t i = 0; i != poolSize; ++i)
+        CHECK( pool.try_lease(pos, 0) );
+}
+
+TEST_CASE("Connection pool statistics", "[core][pool]")
+{
+    connection_pool pool(3);
+
+    auto stats = pool.get_stats();
+    CHECK( stats.size == 3 );
+    CHECK( stats.in_use == 0 );
+    CHECK( stats.free == 3 );
+    CHECK( stats.leases == 0 );
+
+    std::size_t const pos1 = pool.lease();
+    std::size_t const pos2 = pool.lease();
+
+    stats = pool.get_stats();
+    CHECK( stats.in_use == 2 );
+    CHECK( stats.free == 1 );
+    CHECK( stats.high_water_mark == 2 );
+    CHECK( stats.leases == 2 );
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    pool.give_back(pos1);
+
+    std::size_t pos3 = 0;
+    REQUIRE( pool.try_lease(pos3, 0) );
+    std::size_t pos4 = 0;
+    REQUIRE( pool.try_lease(pos4, 0) );
+    CHECK( !pool.try_lease(pos4, 1) );
+
+    pool.give_back(pos2);
+    pool.give_back(pos3);
+    pool.give_back(pos4);
+
+    stats = pool.get_stats();
+    CHECK( stats.in_use == 0 );
+    CHECK( stats.free == 3 );
+    CHECK( stats.high_water_mark == 3 );
+    CHECK( stats.leases == 4 );
+    CHECK( stats.timeouts == 1 );
+
+    std::uint64_t waits = 0;
+    for (auto n : stats.wait_time)
+        waits += n;
+    CHECK( waits == stats.leases );
+
+    // At least one session was held for 2ms, i.e. 2000us, which falls into
+    // the bucket with index 11 or a later one.
+    std::uint64_t holds = 0, longHolds = 0;
+    for (std::size_t n = 0; n != stats.hold_time.size(); ++n)
+    {
+        holds += stats.hold_time[n];
+        if (n >= 11)
+            longHolds += stats.hold_time[n];
+    }
+    CHECK( holds == 4 );
+    CHECK( longHolds >= 1 );
+}
+
+TEST_CASE("Connection pool priorities", "[core][pool]")
+{
+    connection_pool pool(2);
+
+    std::size_t const pos1 = pool.lease();
+    std::size_t const pos2 = pool.lease();
+
+    // Requests whose deadline has already passed fail immediately.
+    std::size_t pos = 0;
+    CHECK( !pool.try_lease(pos, lease_priority::high,
+                           std::chrono::steady_clock::now()) );
+
+    // Start the waiters in the order of increasing priority: they must be
+    // served in the opposite one, and in FIFO order for the same priority.
+    std::mutex mtx;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+    auto const startWaiter = [&](lease_priority priority, int id) {
+        threads.emplace_back([&, priority, id]() {
+            std::size_t const n = pool.lease(priority);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                order.push_back(id);
+            }
+            pool.give_back(n);
+        });
+
+        // Give the thread time to start waiting.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    };
+
+    startWaiter(lease_priority::low, 1);
+    startWaiter(lease_priority::normal, 2);
+    startWaiter(lease_priority::normal, 3);
+    startWaiter(lease_priority::high, 4);
+
+    // This request expires while waiting and must not prevent the others
+    // from getting the entries.
+    CHECK( !pool.try_lease(pos, lease_priority::high,
+                           std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(1)) );
+
+    // Give back only one entry to serve the waiters one by one.
+    pool.give_back(pos1);
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE( order.size() == 4 );
+    CHECK( order[0] == 4 );
+    CHECK( order[1] == 2 );
+    CHECK( order[2] == 3 );
+    CHECK( order[3] == 1 );
+
+    // Reserve the last free entry for high priority requests.
+    pool.set_reserved_capacity(lease_priority::high, 1);
+    CHECK( !pool.try_lease(pos, 0) );
+    CHECK( !pool.try_lease(pos, lease_priority::normal,
+                           std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(1)) );
+    REQUIRE( pool.try_lease(pos, lease_priority::high,
+                            std::chrono::steady_clock::now()) );
+    pool.give_back(pos);
+
+    // With 2 free entries, one of them can be used by the normal requests.
+    pool.give_back(pos2);
+    REQUIRE( pool.try_lease(pos, 0) );
+    std::size_t pos3 = 0;
+    CHECK( !pool.try_lease(pos3, 0) );
+    pool.give_back(pos);
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool opening sessions", "[core][pool]")
+{
+    connection_pool_options options;
+    options.min_size = 1;
+    options.max_size = 3;
+    options.idle_timeout = std::chrono::milliseconds(1);
+    options.validation_interval = std::chrono::milliseconds(1);
+
+    connection_pool pool(connection_parameters(backEndFactory_, connectString_),
+                         options);
+    REQUIRE( pool.size() == 3 );
+
+    // Sessions are only opened when they're needed.
+    for (std::size_t i = 0; i != pool.size(); ++i)
+        CHECK( !pool.at(i).is_connected() );
+
+    {
+        soci::session sql1(pool);
+        soci::session sql2(pool);
+        CHECK( sql1.is_connected() );
+        CHECK( sql2.is_connected() );
+    }
+
+    CHECK( pool.at(0).is_connected() );
+    CHECK( pool.at(1).is_connected() );
+    CHECK( !pool.at(2).is_connected() );
+
+    // Idle sessions are closed, but not all of them.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    pool.maintain();
+
+    CHECK( pool.at(0).is_connected() );
+    CHECK( !pool.at(1).is_connected() );
+
+    // Sessions which were closed are reopened when leased.
+    pool.at(0).close();
+    {
+        soci::session sql(pool);
+        CHECK( sql.is_connected() );
+    }
+
+    // And the minimal number of them is reopened by maintain().
+    pool.at(0).close();
+    pool.maintain();
+    CHECK( pool.at(0).is_connected() );
+
+    options.min_size = 4;
+    CHECK_THROWS_AS( connection_pool(connection_parameters(backEndFactory_,
+                                                           connectString_),
+                                     options),
+                     soci_error );
+
+    CHECK_THROWS_AS( connection_pool(1).maintain(), soci_error );
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool maintenance thread", "[core][pool]")
+{
+    connection_pool_options options;
+    options.min_size = 2;
+    options.max_size = 2;
+    options.maintenance_interval = std::chrono::hours(1);
+
+    auto const start = std::chrono::steady_clock::now();
+    {
+        connection_pool pool(connection_parameters(backEndFactory_, connectString_),
+                             options);
+
+        soci::session sql(pool);
+        CHECK( sql.is_connected() );
+    }
+
+    // Destroying the pool must not wait until the next maintenance.
+    CHECK( std::chrono::steady_clock::now() - start < std::chrono::minutes(1) );
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool warm-up", "[core][pool]")
+{
+    std::string dummyFrom;
+    {
+        soci::session sql(backEndFactory_, connectString_);
+        dummyFrom = sql.get_dummy_from_clause();
+    }
+
+    std::atomic<int> warmedUp{0};
+
+    connection_pool_options options;
+    options.min_size = 1;
+    options.max_size = 2;
+    options.warm_up = [&warmedUp](soci::session & sql) {
+        CHECK( sql.is_connected() );
+        ++warmedUp;
+    };
+    options.prepared_statements["answer"] = "select 42" + dummyFrom;
+
+    connection_pool pool(connection_parameters(backEndFactory_, connectString_),
+                         options);
+
+    // The sessions opened by maintain() are warmed up too.
+    pool.maintain();
+    CHECK( warmedUp == 1 );
+    CHECK( pool.at(0).has_prepared_statement("answer") );
+
+    {
+        soci::session sql(pool);
+        CHECK( warmedUp == 1 );
+
+        // The statement can be executed as many times as needed.
+        for (int i = 0; i != 2; ++i)
+        {
+            statement & st = sql.get_prepared_statement("answer");
+
+            int n = 0;
+            st.exchange(into(n));
+            st.define_and_bind();
+            CHECK( st.execute(true) );
+            CHECK( n == 42 );
+
+            st.bind_clean_up();
+        }
+
+        CHECK_THROWS_AS( sql.get_prepared_statement("question"), soci_error );
+
+        // Don't call bind_clean_up() this time, this is done by the pool.
+        int n = 0;
+        statement & st = sql.get_prepared_statement("answer");
+        st.exchange(into(n));
+        st.define_and_bind();
+        CHECK( st.execute(true) );
+    }
+
+    {
+        // The same session is leased again and the statement can be used
+        // with the new variables, not referring to the old one any more.
+        soci::session sql(pool);
+        REQUIRE( sql.has_prepared_statement("answer") );
+
+        int m = 0;
+        statement & st = sql.get_prepared_statement("answer");
+        st.exchange(into(m));
+        st.define_and_bind();
+        CHECK( st.execute(true) );
+        CHECK( m == 42 );
+
+        st.bind_clean_up();
+    }
+
+    // Closing the session discards the prepared statements, but they're
+    // prepared again when the pool reopens it.
+    pool.at(0).close();
+    CHECK( !pool.at(0).has_prepared_statement("answer") );
+
+    {
+        soci::session sql(pool);
+        CHECK( warmedUp == 2 );
+        CHECK( sql.has_prepared_statement("answer") );
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool session statistics", "[core][pool][statistics]")
+{
+    std::string query;
+    {
+        soci::session sql(backEndFactory_, connectString_);
+        query = "select 42" + sql.get_dummy_from_clause();
+    }
+
+    connection_pool_options options;
+    options.max_size = 2;
+    options.prepared_statements["answer"] = query;
+    options.collect_statistics = true;
+
+    connection_pool pool(connection_parameters(backEndFactory_, connectString_),
+                         options);
+
+    {
+        soci::session sql1(pool);
+        soci::session sql2(pool);
+        CHECK( sql1.get_collect_statistics() );
+
+        int n = 0;
+        statement & st = sql1.get_prepared_statement("answer");
+        st.exchange(into(n));
+        st.define_and_bind();
+        CHECK( st.execute(true) );
+        st.bind_clean_up();
+
+        sql2 << query, into(n);
+        CHECK( n == 42 );
+    }
+
+    // Both sessions have prepared the statement when they were opened, and
+    // the second one prepared it once again.
+    auto const stats = pool.get_statistics();
+    CHECK( stats.statements_prepared == 3 );
+    CHECK( stats.statements_executed == 2 );
+    CHECK( stats.cache_hits == 1 );
+    CHECK( stats.rows_fetched == 2 );
+
+    // The statistics of the same query in both sessions are combined.
+    REQUIRE( stats.top_queries.size() == 1 );
+    CHECK( stats.top_queries[0].query ==
+            query_fingerprint(query, pool.at(0).get_database_engine()).str() );
+    CHECK( stats.top_queries[0].executions == 2 );
+}
+
+// Backend factory which always fails to open the session, as if the database
+// were unreachable.
+struct unreachable_backend_factory : backend_factory
+{
+    details::session_backend* make_session(
+        connection_parameters const& /* parameters */) const override
+    {
+        throw soci_error("Database is unreachable");
+    }
+};
+
+TEST_CASE_METHOD(common_tests, "Connection pool routing", "[core][pool]")
+{
+    unreachable_backend_factory const unreachable;
+
+    connection_parameters const params(backEndFactory_, connectString_);
+
+    // The first replica can't be opened at all.
+    std::vector<connection_parameters> replicas;
+    replicas.push_back(connection_parameters(unreachable, "dummy"));
+    replicas.push_back(params);
+    replicas.push_back(params);
+
+    routing_pool_options options;
+    options.pool.max_size = 1;
+    options.ejection_time = std::chrono::hours(1);
+
+    routing_pool pool(params, replicas, options);
+    REQUIRE( pool.replicas_count() == 3 );
+
+    {
+        soci::session sqlWrite(pool, access_intent::write);
+        CHECK( sqlWrite.is_connected() );
+        CHECK( pool.primary().get_stats().in_use == 1 );
+    }
+
+    {
+        // The broken replica is ejected and the reads are balanced between
+        // the remaining ones, falling back to the primary when they're busy.
+        soci::session sqlRead1(pool, access_intent::read);
+        CHECK( sqlRead1.is_connected() );
+        CHECK( pool.is_replica_ejected(0) );
+
+        soci::session sqlRead2(pool, access_intent::read);
+        CHECK( pool.replica(1).get_stats().in_use == 1 );
+        CHECK( pool.replica(2).get_stats().in_use == 1 );
+
+        soci::session sqlRead3(pool, access_intent::read);
+        CHECK( pool.primary().get_stats().in_use == 1 );
+    }
+
+    CHECK( pool.replica(1).get_stats().in_use == 0 );
+    CHECK( pool.replica(2).get_stats().in_use == 0 );
+
+    pool.eject_replica(1);
+    {
+        soci::session sqlRead(pool, access_intent::read);
+        CHECK( pool.replica(2).get_stats().in_use == 1 );
+    }
+
+    CHECK_THROWS_AS( pool.eject_replica(3), soci_error );
+
+    // When all replicas are ejected, the reads use the primary...
+    pool.eject_replica(2);
+    {
+        soci::session sqlRead(pool, access_intent::read);
+        CHECK( pool.primary().get_stats().in_use == 1 );
+    }
+
+    // ... unless this is disabled.
+    options.read_from_primary = false;
+    routing_pool poolNoPrimary(params, replicas, options);
+    poolNoPrimary.eject_replica(1);
+    poolNoPrimary.eject_replica(2);
+    CHECK_THROWS_AS( soci::session(poolNoPrimary, access_intent::read), soci_error );
+    CHECK( poolNoPrimary.primary().get_stats().in_use == 0 );
+
+    // Reads waiting for a busy replica use another one if it becomes free
+    // first.
+    options.read_from_primary = true;
+    options.wait_interval = std::chrono::milliseconds(10);
+    routing_pool poolWait(params, std::vector<connection_parameters>{params, params},
+                          options);
+    {
+        soci::session sqlWrite(poolWait, access_intent::write);
+        soci::session sqlRead1(poolWait, access_intent::read);
+        auto sqlRead2 = std::make_unique<soci::session>(poolWait, access_intent::read);
+        CHECK( poolWait.replica(0).in_use() == 1 );
+        CHECK( poolWait.replica(1).in_use() == 1 );
+
+        std::atomic<bool> leased{false};
+        std::thread t([&poolWait, &leased]() {
+            soci::session sqlRead3(poolWait, access_intent::read);
+            leased = true;
+        });
+
+        // Let the thread start waiting for the first replica.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK( !leased );
+
+        sqlRead2.reset();
+        t.join();
+        CHECK( leased );
+        CHECK( poolWait.replica(1).get_stats().leases == 2 );
+    }
+}
+
+} // namespace tests
+
+} // namespace soci
@@ -329,6 +329,75 @@ TEST_CASE_METHOD(common_tests, "Reading ints from rowset", "[core][rowset]")
 
 }
 
+// test for reading rowset using prefetch option
+TEST_CASE_METHOD(common_tests, "Reading rowset in batches", "[core][rowset]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    {
+        rowset<int> rs((sql.prepare << "select id from soci_test"), prefetch(3));
+        CHECK(rs.begin() == rs.end());
+    }
+
+    for (int i = 1; i <= 10; ++i)
+    {
+        std::string const str = std::to_string(i);
+        sql << "insert into soci_test(id, str) values(:id, :str)",
+            use(i), use(str);
+    }
+
+    // Use batch sizes smaller, bigger than and dividing the number of rows.
+    for (std::size_t const size : { 1, 3, 5, 100 })
+    {
+        rowset<int> rs((sql.prepare << "select id from soci_test order by id"),
+                       prefetch(size));
+
+        std::vector<int> ids(rs.begin(), rs.end());
+        REQUIRE(ids.size() == 10);
+        for (int i = 0; i != 10; ++i)
+        {
+            CHECK(ids[i] == i + 1);
+        }
+    }
+
+    {
+        int const minId = 4;
+        rowset<std::string> rs((sql.prepare
+                << "select str from soci_test where id >= :id order by id",
+                use(minId)), prefetch(4));
+
+        rowset<std::string>::const_iterator pos = rs.begin();
+        CHECK(*pos == "4");
+
+        std::advance(pos, 4);
+        CHECK(*pos == "8");
+
+        std::advance(pos, 2);
+        CHECK(*pos == "10");
+
+        ++pos;
+        CHECK(pos == rs.end());
+    }
+
+    {
+        // Tuples use a vector for each column.
+        rowset<std::tuple<int, std::string> > rs((sql.prepare
+                << "select id, str from soci_test order by id"), prefetch(3));
+
+        int n = 0;
+        for (auto const & t : rs)
+        {
+            ++n;
+            CHECK(std::get<0>(t) == n);
+            CHECK(std::get<1>(t) == std::to_string(n));
+        }
+
+        CHECK(n == 10);
+    }
+}
+
 // test for handling 'use' and reading rowset<std::string> using iterator
 TEST_CASE_METHOD(common_tests, "Reading strings from rowset", "[core][rowset]")
 {
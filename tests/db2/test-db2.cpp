@@ -397,3 +397,52 @@ TEST_CASE("DB2 test 3", "[db2]")
     sql<<"DROP TABLE DB2INST1.SOCI_TEST";
     sql.commit();
 }
+
+TEST_CASE("DB2 bulk insert with errors", "[db2][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    sql << "CREATE TABLE DB2INST1.SOCI_TEST (ID INTEGER NOT NULL PRIMARY KEY)";
+
+    std::vector<int> ids{1, 2, 2, 3, 1, 4};
+
+    {
+        // By default, an exception is thrown and the failing rows are known.
+        statement st = (sql.prepare <<
+            "insert into db2inst1.SOCI_TEST (id) values (:id)", use(ids));
+        CHECK_THROWS_AS(st.execute(true), soci_error);
+
+        auto* const db2Statement = static_cast<db2_statement_backend*>(st.get_backend());
+        CHECK(db2Statement->get_bulk_errors_count() != 0);
+
+        sql << "DELETE FROM DB2INST1.SOCI_TEST";
+    }
+
+    {
+        statement st = (sql.prepare <<
+            "insert into db2inst1.SOCI_TEST (id) values (:id)", use(ids));
+
+        auto* const db2Statement = static_cast<db2_statement_backend*>(st.get_backend());
+        db2Statement->set_continue_on_error(true);
+        st.execute(true);
+
+        auto const& results = db2Statement->get_bulk_results();
+        REQUIRE(results.size() == ids.size());
+        CHECK(results[0].succeeded());
+        CHECK(results[1].succeeded());
+        CHECK(!results[2].succeeded());
+        CHECK(results[3].succeeded());
+        CHECK(!results[4].succeeded());
+        CHECK(results[5].succeeded());
+
+        CHECK(db2Statement->get_bulk_errors_count() == 2);
+        CHECK(st.get_affected_rows() == 4);
+    }
+
+    int count = 0;
+    sql << "SELECT COUNT(*) FROM DB2INST1.SOCI_TEST", into(count);
+    CHECK(count == 4);
+
+    sql<<"DROP TABLE DB2INST1.SOCI_TEST";
+    sql.commit();
+}
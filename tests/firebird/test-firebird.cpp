@@ -1112,6 +1112,182 @@ TEST_CASE("Firebird next value", "[firebird][get_next_sequence_value()]")
     sql << "drop sequence seqtest";
 }
 
+// Bulk insert which may use the batch API if it's available.
+TEST_CASE("Firebird bulk insert", "[firebird][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    try
+    {
+        sql << "drop table test_bulk";
+    }
+    catch (soci_error const &)
+    {} // ignore if error
+
+    sql << "create table test_bulk (id integer not null primary key, "
+           "s varchar(20), d double precision)";
+    sql.commit();
+
+    sql.begin();
+
+    int const rowsToTest = 10000;
+
+    std::vector<int> ids(rowsToTest);
+    std::vector<std::string> strs(rowsToTest);
+    std::vector<double> doubles(rowsToTest);
+    std::vector<indicator> inds(rowsToTest, i_ok);
+    for (int i = 0; i != rowsToTest; ++i)
+    {
+        ids[i] = i;
+        strs[i] = fmt::format("str{}", i);
+        doubles[i] = i / 2.;
+        if (i % 10 == 0)
+            inds[i] = i_null;
+    }
+
+    {
+        statement st = (sql.prepare <<
+            "insert into test_bulk(id, s, d) values(:id, :s, :d)",
+            use(ids), use(strs, inds), use(doubles));
+        st.execute(true);
+        CHECK(st.get_affected_rows() == rowsToTest);
+    }
+
+    int count = 0;
+    sql << "select count(*) from test_bulk", into(count);
+    CHECK(count == rowsToTest);
+
+    sql << "select count(*) from test_bulk where s is null", into(count);
+    CHECK(count == rowsToTest / 10);
+
+    std::string s;
+    double d = 0;
+    sql << "select s, d from test_bulk where id = 1234", into(s), into(d);
+    CHECK(s == "str1234");
+    CHECK(d == 617.);
+
+    // Check that the rows preceding the one resulting in an error are still
+    // inserted.
+    sql << "delete from test_bulk";
+
+    ids.assign({1, 2, 3, 2, 5});
+    strs.resize(ids.size());
+    doubles.resize(ids.size());
+    inds.assign(ids.size(), i_ok);
+
+    {
+        statement st = (sql.prepare <<
+            "insert into test_bulk(id, s, d) values(:id, :s, :d)",
+            use(ids), use(strs, inds), use(doubles));
+        CHECK_THROWS_AS(st.execute(true), soci_error);
+        CHECK(st.get_affected_rows() == 3);
+    }
+
+    sql << "select count(*) from test_bulk", into(count);
+    CHECK(count == 3);
+
+    sql.commit();
+
+    sql << "drop table test_bulk";
+}
+
+TEST_CASE("Firebird statement cache", "[firebird][cache]")
+{
+    soci::session sql(backEnd, connectString + " stmt_cache_size=2");
+
+    auto const fbSession =
+        static_cast<firebird_session_backend*>(sql.get_backend());
+    CHECK(fbSession->get_statement_cache_size() == 2);
+
+    try
+    {
+        sql << "drop table test_cache";
+    }
+    catch (soci_error const &)
+    {} // ignore if error
+
+    sql << "create table test_cache (id integer, s varchar(20), d double precision)";
+    sql.commit();
+
+    sql.begin();
+
+    // DDL statements are never cached.
+    CHECK(fbSession->get_cached_statements_count() == 0);
+
+    for (int i = 0; i != 10; ++i)
+    {
+        std::string const s = fmt::format("str{}", i);
+        double const d = i / 4.;
+        indicator ind = i % 3 == 0 ? i_null : i_ok;
+        sql << "insert into test_cache(id, s, d) values(:id, :s, :d)",
+            use(i), use(s, ind), use(d);
+    }
+
+    CHECK(fbSession->get_cached_statements_count() == 1);
+
+    int count = 0;
+    for (int i = 0; i != 3; ++i)
+    {
+        sql << "select count(*) from test_cache", into(count);
+        CHECK(count == 10);
+    }
+
+    CHECK(fbSession->get_cached_statements_count() == 2);
+
+    // Check that cached statements using named parameters still work.
+    int id = 0;
+    std::string const str7("str7");
+    for (int i = 0; i != 3; ++i)
+    {
+        sql << "select id from test_cache where s = :s", use(str7, "s"), into(id);
+        CHECK(id == 7);
+    }
+
+    // The cache size is limited.
+    CHECK(fbSession->get_cached_statements_count() == 2);
+
+    // Check fetching into vectors, which uses a different code path for the
+    // types used here.
+    {
+        std::vector<int> ids(4);
+        std::vector<std::string> strs(4);
+        std::vector<indicator> inds(4);
+        std::vector<double> doubles(4);
+        statement st = (sql.prepare <<
+            "select id, s, d from test_cache order by id",
+            into(ids), into(strs, inds), into(doubles));
+        st.execute();
+
+        int n = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != ids.size(); ++i, ++n)
+            {
+                CHECK(ids[i] == n);
+                if (n % 3 == 0)
+                {
+                    CHECK(inds[i] == i_null);
+                }
+                else
+                {
+                    CHECK(inds[i] == i_ok);
+                    CHECK(strs[i] == fmt::format("str{}", n));
+                }
+                CHECK(doubles[i] == n / 4.);
+            }
+        }
+        CHECK(n == 10);
+    }
+
+    sql.commit();
+
+    // Dropping the table must work even though it is used by the cached
+    // statements.
+    sql << "drop table test_cache";
+
+    CHECK(fbSession->get_cached_statements_count() == 0);
+}
+
 //
 // Support for soci Common Tests
 //
@@ -201,6 +201,47 @@ TEST_CASE("MS SQL table records count", "[odbc][mssql][count]")
     CHECK(hasTables);
 }
 
+TEST_CASE("MS SQL bulk insert continuing on error", "[odbc][mssql][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    struct unique_table_creator : public table_creator_base
+    {
+        unique_table_creator(soci::session & sql)
+            : table_creator_base(sql)
+        {
+            sql << "create table soci_test(id integer primary key)";
+        }
+    } tableCreator(sql);
+
+    std::vector<int> ids{1, 2, 2, 3, 1};
+
+    statement st = (sql.prepare << "insert into soci_test(id) values(:id)", use(ids));
+
+    auto* const odbcStatement = static_cast<odbc_statement_backend*>(st.get_backend());
+    odbcStatement->set_continue_on_error(true);
+
+    REQUIRE_NOTHROW(st.execute(true));
+
+    auto const& results = odbcStatement->get_bulk_results();
+    REQUIRE(results.size() == ids.size());
+    CHECK(odbcStatement->get_bulk_errors_count() == 2);
+    CHECK(results[0].succeeded());
+    CHECK(results[1].succeeded());
+    CHECK(!results[2].succeeded());
+    CHECK(results[3].succeeded());
+    CHECK(!results[4].succeeded());
+
+    REQUIRE(!results[2].diagnostics.empty());
+    CHECK(results[2].diagnostics[0].sqlstate == "23000");
+
+    CHECK(st.get_affected_rows() == 3);
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 3);
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {
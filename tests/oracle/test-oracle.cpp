@@ -563,6 +563,40 @@ TEST_CASE("Oracle bulk insert", "[oracle][insert][bulk]")
         sql << "delete from soci_test";
     }
 
+    // verify that all the errors are reported when continuing after them
+    {
+        std::vector<int> ids;
+        ids.push_back(1);
+        ids.push_back(1000000); // too big for column
+        ids.push_back(2);
+        ids.push_back(2000000); // too big for column
+        ids.push_back(3);
+
+        statement st = (sql.prepare << "insert into soci_test (id) values(:id)",
+                        use(ids, "id"));
+
+        auto const stBackend =
+            static_cast<oracle_statement_backend*>(st.get_backend());
+        stBackend->set_continue_on_error(true);
+
+        CHECK_NOTHROW(st.execute(true));
+        CHECK(st.get_affected_rows() == 3);
+
+        auto const& errors = stBackend->get_batch_errors();
+        REQUIRE(errors.size() == 2);
+        CHECK(errors[0].row == 1);
+        CHECK(errors[0].error_code == 1438);
+        CHECK(errors[0].message.find("ORA-01438") != std::string::npos);
+        CHECK(errors[1].row == 3);
+        CHECK(errors[1].error_code == 1438);
+
+        sql.commit();
+        int count(7);
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 3);
+        sql << "delete from soci_test";
+    }
+
     // test insert
     {
         std::vector<int> ids;
@@ -1574,6 +1608,86 @@ TEST_CASE("next sequence value", "[oracle][get_next_sequence_value()]")
     }
 }
 
+TEST_CASE("Oracle statement cache and prefetch", "[oracle][stmtcache]")
+{
+    soci::session sql(backEnd, connectString + " stmt_cache_size=10 prefetch_rows=50");
+
+    auto const sessionBackend =
+        static_cast<oracle_session_backend*>(sql.get_backend());
+    CHECK(sessionBackend->get_statement_cache_size() == 10);
+    CHECK(sessionBackend->get_prefetch_rows() == 50);
+    CHECK(sessionBackend->get_prefetch_memory() == 0);
+
+    longlong_table_creator tableCreator(sql);
+
+    // Execute the same query several times to reuse the cached statement.
+    for (int i = 0; i != 100; ++i)
+    {
+        sql << "insert into soci_test(val) values(:val)", use(i);
+    }
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 100);
+
+    long long val = 0;
+    statement st = (sql.prepare << "select val from soci_test order by val",
+                    into(val));
+    static_cast<oracle_statement_backend*>(st.get_backend())
+        ->set_prefetch_rows(7);
+    st.execute();
+
+    long long expected = 0;
+    while (st.fetch())
+    {
+        CHECK(val == expected);
+        ++expected;
+    }
+    CHECK(expected == 100);
+}
+
+TEST_CASE("Oracle session pool", "[oracle][pool]")
+{
+    std::string const poolConnectString = connectString + " session_pool_max=2";
+
+    const std::size_t pool_size = 4;
+    connection_pool pool(pool_size);
+    for (std::size_t i = 0; i != pool_size; ++i)
+    {
+        pool.at(i).open(backEnd, poolConnectString);
+    }
+
+    oracle_session_pool* const spool =
+        static_cast<oracle_session_backend*>(pool.at(0).get_backend())
+            ->get_session_pool();
+    REQUIRE(spool);
+
+    // All sessions use the same OCI pool.
+    for (std::size_t i = 1; i != pool_size; ++i)
+    {
+        CHECK(static_cast<oracle_session_backend*>(pool.at(i).get_backend())
+                ->get_session_pool() == spool);
+    }
+
+    // No OCI sessions are used before executing any statements.
+    CHECK(spool->get_busy_count() == 0);
+
+    // Using more sessions than the size of OCI pool sequentially works as
+    // they release their OCI sessions when they're given back.
+    for (int n = 0; n != 10; ++n)
+    {
+        soci::session sql(pool);
+
+        int i = 0;
+        sql << "select " << n << " from dual", into(i);
+        CHECK(i == n);
+        CHECK(spool->get_busy_count() == 1);
+    }
+
+    CHECK(spool->get_busy_count() == 0);
+    CHECK(spool->get_open_count() <= 2);
+}
+
 
 //
 // Support for soci Common Tests
@@ -952,6 +952,40 @@ TEST_CASE("SQLite row int64", "[sqlite][row][int64]")
     CHECK(r.get<std::int64_t>("val") == val);
 }
 
+TEST_CASE("SQLite lazy row conversion", "[sqlite][row][lazy]")
+{
+    soci::session sql(backEnd, connectString);
+    struct date_table_creator : table_creator_base
+    {
+        date_table_creator(soci::session &sql)
+            : table_creator_base(sql)
+        {
+            sql << "create table soci_test(id integer, d date)";
+        }
+    } creator(sql);
+
+    sql << "insert into soci_test(id, d) values (1, 'not a date')";
+
+    row r;
+    CHECK_THROWS_AS((sql << "select id, d from soci_test", into(r)), soci_error);
+
+    // With lazy conversion, the invalid value is only a problem if it's used.
+    sql.lazy_row_conversion(true);
+
+    {
+        statement st = (sql.prepare << "select id, d from soci_test", into(r));
+        REQUIRE(st.execute(true));
+
+        CHECK(r.get<int>(0) == 1);
+        CHECK_THROWS_AS(r.get<std::tm>(1), soci_error);
+    }
+
+    // And if it's not accessed while the statement exists, it's reported later.
+    sql << "select id, d from soci_test", into(r);
+    CHECK(r.get<int>(0) == 1);
+    CHECK_THROWS_AS(r.get<std::tm>(1), soci_error);
+}
+
 // The setting "synchronous" cannot be set when the database is locked in
 // environments with parallelisms for example. A timeout solves this issue.
 // This test checks whether the timeout was applied before setting "synchronous".